@@ -21,20 +21,8 @@ limitations under the License.
 
 namespace Units
 {
-   class Speed;
-   class Time;
-   class Mass;
-   class Force;
-
-   class Acceleration
-   {
-   public:
-
-      Speed operator*(const Time& time) const;
-      Force operator*(const Mass& mass) const;
-
-      GENERIC_OPERATORS(Acceleration);
-   };
+   // Base unit is meters per second squared
+   using Acceleration = Quantity<Dimension<1, 0, -2, 0, 0>>;
 } //end namespace Units
 
 //https://www.nist.gov/pml/special-publication-811/nist-guide-si-appendix-b-conversion-factors/nist-guide-si-appendix-b8
@@ -48,6 +36,4 @@ UNIT_TEMPLATE(Acceleration, InchesPerSecondSquared, 0.0254, inps2);
 UNIT_TEMPLATE(Acceleration, Galileo, 0.01, Galileo);
 UNIT_TEMPLATE(Acceleration, MetersPerSecondSquared, 1.0, mps2);
 
-
-
 #endif  // ACCELERATIONTYPE_H_GUARD
@@ -0,0 +1,104 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#ifndef ANGLEMATH_CPP_GUARD
+#define ANGLEMATH_CPP_GUARD
+
+#include "AngleMath.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Units
+{
+   namespace AngleSpans
+   {
+      // Every unit type is laid out as its base unit double (UNIT_LAYOUT_CHECKS)
+      inline std::span<const double> Degrees(std::span<const Angle> angles)
+      {
+         return std::span<const double>(reinterpret_cast<const double*>(angles.data()), angles.size());
+      }
+      inline std::span<double> Degrees(std::span<Angle> angles)
+      {
+         return std::span<double>(reinterpret_cast<double*>(angles.data()), angles.size());
+      }
+   } //end namespace AngleSpans
+
+   UNITS_INLINE void SinCos(std::span<const Angle> angles, std::span<double> sines, std::span<double> cosines)
+   {
+      DegreesSinCos(AngleSpans::Degrees(angles), sines, cosines);
+   }
+
+   UNITS_INLINE void Sin(std::span<const Angle> angles, std::span<double> sines)
+   {
+      DegreesSinCos(AngleSpans::Degrees(angles), sines, std::span<double>());
+   }
+
+   UNITS_INLINE void Cos(std::span<const Angle> angles, std::span<double> cosines)
+   {
+      DegreesSinCos(AngleSpans::Degrees(angles), std::span<double>(), cosines);
+   }
+
+   UNITS_INLINE void Atan2(std::span<const double> y, std::span<const double> x, std::span<Angle> angles)
+   {
+      DegreesAtan2(y, x, AngleSpans::Degrees(angles));
+   }
+
+   UNITS_INLINE void CircularDifference(std::span<const Angle> lhs, std::span<const Angle> rhs, std::span<Angle> differences)
+   {
+      if (lhs.size() != rhs.size())
+      {
+         throw std::invalid_argument("Units::CircularDifference lhs and rhs differ in size");
+      }
+      if (differences.size() < lhs.size())
+      {
+         throw std::invalid_argument("Units::CircularDifference output is smaller than input");
+      }
+
+      // Subtract in one straight loop, then wrap on the batch kernels
+      for (std::size_t i = 0; i < lhs.size(); ++i)
+      {
+         differences[i] = lhs[i] - rhs[i];
+      }
+      const std::span<double> degrees = AngleSpans::Degrees(differences.first(lhs.size()));
+      WrapDegrees(degrees, degrees, AngleWrap::Signed);
+   }
+
+   UNITS_INLINE Angle CircularMean(std::span<const Angle> angles)
+   {
+      double sineSum = 0.0;
+      double cosineSum = 0.0;
+      DegreesSinCosSums(AngleSpans::Degrees(angles), sineSum, cosineSum);
+      return Atan2(sineSum, cosineSum);
+   }
+
+   UNITS_INLINE double CircularVariance(std::span<const Angle> angles)
+   {
+      if (angles.empty())
+      {
+         return 1.0;
+      }
+
+      double sineSum = 0.0;
+      double cosineSum = 0.0;
+      DegreesSinCosSums(AngleSpans::Degrees(angles), sineSum, cosineSum);
+      const double resultant = std::hypot(sineSum, cosineSum) / double(angles.size());
+      // The rounded sums can put the resultant a little past 1
+      return std::max(0.0, 1.0 - resultant);
+   }
+} //end namespace Units
+
+#endif  // ANGLEMATH_CPP_GUARD
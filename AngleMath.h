@@ -0,0 +1,87 @@
+#ifndef ANGLEMATH_H_GUARD
+#define ANGLEMATH_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "AngleType.h"
+#include "Trigonometry.h"
+#include "UnitBatch.h"
+#include <span>
+
+namespace Units
+{
+   // Sine and cosine of an Angle straight from its degrees, whole quarter
+   // turns are removed exactly before the remainder is scaled to radians
+   // (see Trigonometry.h), within 2 ULP
+   constexpr void SinCos(const Angle& angle, double& sine, double& cosine)
+   {
+      Trigonometry::DegreesSinCos(Degrees(angle).value(), sine, cosine);
+   }
+   constexpr double Sin(const Angle& angle)
+   {
+      double sine = 0.0;
+      double cosine = 0.0;
+      SinCos(angle, sine, cosine);
+      return sine;
+   }
+   constexpr double Cos(const Angle& angle)
+   {
+      double sine = 0.0;
+      double cosine = 0.0;
+      SinCos(angle, sine, cosine);
+      return cosine;
+   }
+
+   // atan2(y, x) within [-180, 180] degrees, (0, 0) gives 0. y and x only
+   // need to share a unit.
+   constexpr Angle Atan2(double y, double x)
+   {
+      double radians = 0.0;
+      Trigonometry::Atan2(y, x, radians);
+      return Degrees(radians * (180.0 / Trigonometry::PI));
+   }
+
+   // Shortest turn from rhs to lhs, (-180, 180] degrees. Correct across the
+   // 0 / 360 seam, CircularDifference(Degrees(5.0), Degrees(355.0)) is 10 degrees.
+   constexpr Angle CircularDifference(const Angle& lhs, const Angle& rhs)
+   {
+      Angle difference = lhs - rhs;
+      return difference.LimitAngle();
+   }
+
+   // Batch versions on the SIMD kernels of UnitBatch.h. Either output of
+   // SinCos may be empty when it is not wanted.
+   UNITS_INLINE void SinCos(std::span<const Angle> angles, std::span<double> sines, std::span<double> cosines);
+   UNITS_INLINE void Sin(std::span<const Angle> angles, std::span<double> sines);
+   UNITS_INLINE void Cos(std::span<const Angle> angles, std::span<double> cosines);
+   UNITS_INLINE void Atan2(std::span<const double> y, std::span<const double> x, std::span<Angle> angles);
+   UNITS_INLINE void CircularDifference(std::span<const Angle> lhs, std::span<const Angle> rhs, std::span<Angle> differences);
+
+   // Direction of the mean unit vector, atan2 of the summed sines and
+   // cosines, so headings either side of north average to north. Angles
+   // that cancel out (and an empty span) give 0.
+   UNITS_INLINE Angle CircularMean(std::span<const Angle> angles);
+
+   // 1 - |mean unit vector|, 0 when every angle is the same and 1 when they
+   // cancel out (or the span is empty)
+   UNITS_INLINE double CircularVariance(std::span<const Angle> angles);
+} //end namespace Units
+
+#ifdef UNITS_HEADER_ONLY
+#include "AngleMath.cpp"
+#endif
+
+#endif  // ANGLEMATH_H_GUARD
@@ -14,14 +14,25 @@ See the License for the specific language governing permissionsand
 limitations under the License.
 */
 
+#ifndef ANGLETYPE_CPP_GUARD
+#define ANGLETYPE_CPP_GUARD
+
 #include "AngleType.h"
-#include "AngularSpeedType.h"
-#include "TimeType.h"
+#include "UnitBatch.h"
 
 namespace Units
 {
-   AngularSpeed Angle::operator/(const Time& time) const
+   // Every unit type is laid out as its base unit double (UNIT_LAYOUT_CHECKS)
+   UNITS_INLINE void LimitAnglePositive(std::span<Angle> angles)
+   {
+      const std::span<double> degrees(reinterpret_cast<double*>(angles.data()), angles.size());
+      WrapDegrees(degrees, degrees, AngleWrap::Positive);
+   }
+   UNITS_INLINE void LimitAngle(std::span<Angle> angles)
    {
-      return DegreesPerSecond(m_value / Seconds(time));
+      const std::span<double> degrees(reinterpret_cast<double*>(angles.data()), angles.size());
+      WrapDegrees(degrees, degrees, AngleWrap::Signed);
    }
 } //end namespace Units
+
+#endif  // ANGLETYPE_CPP_GUARD
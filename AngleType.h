@@ -17,53 +17,116 @@ limitations under the License.
 */
 
 #include "UnitBase.h"
+#include <span>
+#include <type_traits>
 
 namespace Units
 {
-   class AngularSpeed;
-   class Time;
+   template <class QuantityType>
+   inline constexpr bool DOUBLE_STORAGE = std::is_same_v<typename QuantityType::storage_type, double>;
 
-   class Angle
+   // Wrapping members shared by every Angle. The members that wrap in place
+   // need double storage, binary angles (BinaryAngle.h) wrap on overflow and
+   // fixed point or float angles convert to Angle to wrap.
+   template <class Derived>
+   class DimensionMembers<Dimension<0, 0, 0, 0, 1>, Derived>
    {
-   public:
+   private:
+      static constexpr double HALF_CIRCLE = 180.0;
+      static constexpr double FULL_CIRCLE = 360.0;
+      static constexpr double INVERSE_FULL_CIRCLE = 1.0 / FULL_CIRCLE;
+      // Adding then subtracting 1.5 * 2^52 rounds any |x| < 2^51 to the nearest
+      // whole number using plain adds, this keeps the wrap free of fmod and
+      // of branches and lets the batch kernels vectorize it without SSE4.1
+      // rounding instructions. Below 2^53 degrees the circles removed are
+      // fewer than 2^45, so circles * FULL_CIRCLE and the difference are
+      // exact. Not valid under -ffast-math, which folds the add/subtract away.
+      static constexpr double ROUNDING_BIAS = 6755399441055744.0;
+      static constexpr double TWO_POW_53 = 9007199254740992.0;
 
-      AngularSpeed operator/(const Time& time) const;
+      // Exact remainder of whole circles for |degrees| >= 2^53, long division
+      // by FULL_CIRCLE * 2^n where every subtraction is exact. Infinity and
+      // NaN give NaN.
+      static constexpr double ReduceLarge(double degrees)
+      {
+         if (!((degrees - degrees) == 0.0))
+         {
+            return degrees - degrees;
+         }
+         double magnitude = (degrees < 0.0) ? -degrees : degrees;
+         double circles = FULL_CIRCLE;
+         while ((circles * 2.0) <= magnitude)
+         {
+            circles *= 2.0;
+         }
+         for (; circles >= FULL_CIRCLE; circles *= 0.5)
+         {
+            magnitude -= (magnitude >= circles) ? circles : 0.0;
+         }
+         return (degrees < 0.0) ? -magnitude : magnitude;
+      }
 
-      GENERIC_OPERATORS(Angle);
+      // Removes the nearest whole number of circles, the result is exact and
+      // within rounding of [-180, 180]. Magnitudes past 2^53 take the rarely
+      // used ReduceLarge branch first.
+      static constexpr double WrapNearest(double degrees)
+      {
+         const double magnitude = (degrees < 0.0) ? -degrees : degrees;
+         const double reduced = (magnitude < TWO_POW_53) ? degrees : ReduceLarge(degrees);
+         const double circles = ((reduced * INVERSE_FULL_CIRCLE) + ROUNDING_BIAS) - ROUNDING_BIAS;
+         return reduced - (circles * FULL_CIRCLE);
+      }
 
-   private:
-      const double HALF_CIRCLE = 180.0;
-      const double FULL_CIRCLE = 360.0;
+      constexpr double& AngleDegrees() { return static_cast<Derived&>(*this).m_value; }
 
    public:
-      Angle& LimitAnglePositive()
+      // [0, 360), infinity and NaN give NaN
+      static constexpr double WrapPositive(double degrees)
       {
-         m_value = fmod(m_value, FULL_CIRCLE);
+         const double wrapped = WrapNearest(degrees);
+         const double positive = wrapped + ((wrapped < 0.0) ? FULL_CIRCLE : 0.0);
+         // A tiny negative remainder rounds up to a full circle
+         return (positive == FULL_CIRCLE) ? 0.0 : positive;
+      }
+      // (-180, 180], infinity and NaN give NaN
+      static constexpr double WrapSigned(double degrees)
+      {
+         const double wrapped = WrapNearest(degrees);
+         return wrapped + ((wrapped <= -HALF_CIRCLE) ? FULL_CIRCLE : 0.0) - ((wrapped > HALF_CIRCLE) ? FULL_CIRCLE : 0.0);
+      }
 
-         if (m_value < 0.0)
-         {
-            m_value += (FULL_CIRCLE);
-         }
-         return *this;
+      constexpr Derived& LimitAnglePositive()
+         requires DOUBLE_STORAGE<Derived>
+      {
+         AngleDegrees() = WrapPositive(AngleDegrees());
+         return static_cast<Derived&>(*this);
       }
-      Angle& LimitAngle360() { return LimitAnglePositive(); }
-      Angle& LimitAngle()
+      constexpr Derived& LimitAngle360()
+         requires DOUBLE_STORAGE<Derived>
       {
-         LimitAnglePositive();
-         if (m_value > HALF_CIRCLE)
-         {
-            m_value -= FULL_CIRCLE;
-         }
-         return *this;
+         return LimitAnglePositive();
+      }
+      constexpr Derived& LimitAngle()
+         requires DOUBLE_STORAGE<Derived>
+      {
+         AngleDegrees() = WrapSigned(AngleDegrees());
+         return static_cast<Derived&>(*this);
       }
-      int Sign()
+      constexpr int Sign()
+         requires DOUBLE_STORAGE<Derived>
       {
          LimitAngle();
-         if (m_value > 0.0) return 1;
-         if (m_value < 0.0) return -1;
-         return 0;
+         return int(AngleDegrees() > 0.0) - int(AngleDegrees() < 0.0);
       }
    };
+
+   // Base unit is degrees
+   using Angle = Quantity<Dimension<0, 0, 0, 0, 1>>;
+
+   // Batch versions of the member functions on the SIMD kernels of
+   // UnitBatch.h (WrapDegrees), the same bits as the members
+   UNITS_INLINE void LimitAnglePositive(std::span<Angle> angles);
+   UNITS_INLINE void LimitAngle(std::span<Angle> angles);
 } //end namespace Units
 
 UNIT_TEMPLATE(Angle, Degrees, 1.0, deg); // 360 degrees for a full circle
@@ -74,4 +137,8 @@ UNIT_TEMPLATE(Angle, Revolution, (1.0 / 360.0), rev); // Full circle
 UNIT_TEMPLATE(Angle, ArcMinute, (1.0 / 60.0), arc_min);
 UNIT_TEMPLATE(Angle, ArcSecond, (1.0 / 3600.0), arc_sec);
 
+#ifdef UNITS_HEADER_ONLY
+#include "AngleType.cpp"
+#endif
+
 #endif  // ANGLETYPE_H_GUARD
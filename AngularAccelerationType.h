@@ -17,30 +17,22 @@ limitations under the License.
 */
 
 #include "UnitBase.h"
+#include "AngleType.h" // Angle members must be visible wherever an Angle can be produced
 #include <ratio>
 
 namespace Units
 {
-   class AngularSpeed;
-   class Time;
-
-   class AngularAcceleration
-   {
-   public:
-
-      AngularSpeed operator*(const Time& time) const;
-
-      GENERIC_OPERATORS(AngularAcceleration);
-   };
+   // Base unit is degrees per second squared
+   using AngularAcceleration = Quantity<Dimension<0, 0, -2, 0, 1>>;
 } //end namespace Units
 UNIT_TEMPLATE(AngularAcceleration, DegreesPerSecondSquared, 1.0, deg_s2);
-UNIT_TEMPLATE(AngularAcceleration, DegreesPerMinuteSquared, 3600.0, deg_m2);
-UNIT_TEMPLATE(AngularAcceleration, DegreesPerHourSquared, 12960000.0, deg_hr2);
+UNIT_TEMPLATE(AngularAcceleration, DegreesPerMinuteSquared, (1.0 / 3600.0), deg_m2);
+UNIT_TEMPLATE(AngularAcceleration, DegreesPerHourSquared, (1.0 / 12960000.0), deg_hr2);
 UNIT_TEMPLATE(AngularAcceleration, RadiansPerSecondSquared, (180.0 / 3.1415926535897932384626433832795028841971), rad_s2);
 UNIT_TEMPLATE(AngularAcceleration, MilliradiansPerSecondSquared, (180.0 / 3200.0), mil_s2);
 UNIT_TEMPLATE(AngularAcceleration, BAMS_PerSecondSquared, (180.0), bams_s2);
 UNIT_TEMPLATE(AngularAcceleration, RevolutionPerSecondSquared, (360.0), rps2);
-UNIT_TEMPLATE(AngularAcceleration, RevolutionPerMinuteSquared, ((360.0) * 3600), rpm2);
-UNIT_TEMPLATE(AngularAcceleration, RevolutionPerHourSquared, ((360.0) * 12960000.0), rph2);
+UNIT_TEMPLATE(AngularAcceleration, RevolutionPerMinuteSquared, (360.0 / 3600.0), rpm2);
+UNIT_TEMPLATE(AngularAcceleration, RevolutionPerHourSquared, (360.0 / 12960000.0), rph2);
 
 #endif  // ANGULARACCELERATIONTYPE_H_GUARD
@@ -17,33 +17,23 @@ limitations under the License.
 */
 
 #include "UnitBase.h"
+#include "AngleType.h" // Angle members must be visible wherever an Angle can be produced
 #include <ratio>
 
 namespace Units
 {
-   class Angle;
-   class AngularAcceleration;
-   class Time;
-
-   class AngularSpeed
-   {
-   public:
-
-      Angle operator*(const Time& time) const;
-      AngularAcceleration operator/(const Time& time) const;
-
-      GENERIC_OPERATORS(AngularSpeed);
-   };
+   // Base unit is degrees per second
+   using AngularSpeed = Quantity<Dimension<0, 0, -1, 0, 1>>;
 } //end namespace Units
 
 UNIT_TEMPLATE(AngularSpeed, DegreesPerSecond, 1.0, deg_s);
-UNIT_TEMPLATE(AngularSpeed, DegreesPerMinute, 60.0, deg_m);
-UNIT_TEMPLATE(AngularSpeed, DegreesPerHour, 3600.0, deg_hr);
+UNIT_TEMPLATE(AngularSpeed, DegreesPerMinute, (1.0 / 60.0), deg_m);
+UNIT_TEMPLATE(AngularSpeed, DegreesPerHour, (1.0 / 3600.0), deg_hr);
 UNIT_TEMPLATE(AngularSpeed, RadiansPerSecond, (180.0 / 3.1415926535897932384626433832795028841971), rad_s);
 UNIT_TEMPLATE(AngularSpeed, MilliradiansPerSecond, (180.0 / 3200.0), mil_s);
 UNIT_TEMPLATE(AngularSpeed, BAMS_PerSecond, (180.0), bams_s);
 UNIT_TEMPLATE(AngularSpeed, RevolutionPerSecond, (360.0), rps);
-UNIT_TEMPLATE(AngularSpeed, RevolutionPerMinute, ((360.0) * 60), rpm);
-UNIT_TEMPLATE(AngularSpeed, RevolutionPerHour, ((360.0) * 3600), rph);
+UNIT_TEMPLATE(AngularSpeed, RevolutionPerMinute, (360.0 / 60.0), rpm);
+UNIT_TEMPLATE(AngularSpeed, RevolutionPerHour, (360.0 / 3600.0), rph);
 
 #endif  // ANGULARSPEEDTYPE_H_GUARD
@@ -21,18 +21,8 @@ limitations under the License.
 
 namespace Units
 {
-   class Length;
-   class Volume;
-
-   class Area
-   {
-   public:
-
-      Volume operator*(const Length& length) const;
-      Length operator/(const Length& length) const;
-
-      GENERIC_OPERATORS(Area);
-   };
+   // Base unit is square meters
+   using Area = Quantity<Dimension<2, 0, 0, 0, 0>>;
 } //end namespace Units
 
 //https://www.nist.gov/pml/special-publication-811/nist-guide-si-appendix-b-conversion-factors/nist-guide-si-appendix-b8
@@ -54,5 +44,4 @@ UNIT_TEMPLATE(Area, SquareMicrometers, ((double(std::micro::num) / double(std::m
 UNIT_TEMPLATE(Area, SquareNanometers, ((double(std::nano::num) / double(std::nano::den)) * (double(std::nano::num) / double(std::nano::den))), nm2);
 UNIT_TEMPLATE(Area, SquarePicometers, ((double(std::pico::num) / double(std::pico::den)) * (double(std::pico::num) / double(std::pico::den))), pm2);
 
-
 #endif  // AREATYPE_H_GUARD
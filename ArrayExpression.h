@@ -0,0 +1,258 @@
+#ifndef ARRAYEXPRESSION_H_GUARD
+#define ARRAYEXPRESSION_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include <bit>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Units
+{
+   template <class Element>
+   class QuantityArray;
+
+   // Arithmetic on QuantityArrays builds a tree of these nodes at compile time
+   // instead of computing a temporary array per operator. Nothing is computed
+   // until the tree is assigned to a QuantityArray, which then runs one loop
+   // over every element:
+   //    QuantityArray<Speed> speed = (newPosition - oldPosition) / frameTime;
+   // The element type of every node is the type the scalar operators give,
+   // so dimension errors are compile errors as they are for single values.
+   // Nodes refer to the arrays they were built from, assign them within the
+   // same statement rather than keeping them with auto.
+   namespace ArrayExpressions
+   {
+      // An array in the tree
+      template <class Element>
+      class Terminal
+      {
+      public:
+         using element_type = Element;
+         static constexpr bool scalar = false;
+
+         explicit Terminal(const QuantityArray<Element>& array) : m_values(array.Values().data()), m_size(array.size()) {}
+
+         std::size_t size() const { return m_size; }
+         double Evaluate(std::size_t index) const { return m_values[index]; }
+
+      private:
+         const double* m_values;
+         std::size_t m_size;
+      };
+
+      // A single quantity or double applied to every element
+      template <class Element>
+      class Scalar
+      {
+      public:
+         using element_type = Element;
+         static constexpr bool scalar = true;
+
+         // Every unit type is laid out as its base unit double (UNIT_LAYOUT_CHECKS)
+         explicit Scalar(const Element& value) : m_value(std::bit_cast<double>(value)) {}
+
+         double Evaluate(std::size_t) const { return m_value; }
+
+      private:
+         double m_value;
+      };
+
+      struct Add
+      {
+         static double Apply(double lhs, double rhs) { return lhs + rhs; }
+      };
+      struct Subtract
+      {
+         static double Apply(double lhs, double rhs) { return lhs - rhs; }
+      };
+      struct Multiply
+      {
+         static double Apply(double lhs, double rhs) { return lhs * rhs; }
+      };
+      struct Divide
+      {
+         static double Apply(double lhs, double rhs) { return lhs / rhs; }
+      };
+
+      // Operation applied to two subtrees, at least one of them not a Scalar
+      template <class Element, class Lhs, class Rhs, class Operation>
+      class Node
+      {
+      public:
+         using element_type = Element;
+         static constexpr bool scalar = false;
+
+         Node(const Lhs& lhs, const Rhs& rhs) : m_lhs(lhs), m_rhs(rhs), m_size(Size(lhs, rhs)) {}
+
+         std::size_t size() const { return m_size; }
+         double Evaluate(std::size_t index) const { return Operation::Apply(m_lhs.Evaluate(index), m_rhs.Evaluate(index)); }
+
+      private:
+         static std::size_t Size(const Lhs& lhs, const Rhs& rhs)
+         {
+            if constexpr (Lhs::scalar)
+            {
+               return rhs.size();
+            }
+            else if constexpr (Rhs::scalar)
+            {
+               return lhs.size();
+            }
+            else
+            {
+               if (lhs.size() != rhs.size())
+               {
+                  throw std::invalid_argument("Units::QuantityArray sizes differ");
+               }
+               return lhs.size();
+            }
+         }
+
+         Lhs m_lhs;
+         Rhs m_rhs;
+         std::size_t m_size;
+      };
+
+      // What each kind of operand becomes in the tree
+      template <class T>
+      struct OperandOf
+      {
+      };
+      template <class Element>
+      struct OperandOf<QuantityArray<Element>>
+      {
+         using type = Terminal<Element>;
+         static type Make(const QuantityArray<Element>& array) { return type(array); }
+      };
+      template <class Element, class Lhs, class Rhs, class Operation>
+      struct OperandOf<Node<Element, Lhs, Rhs, Operation>>
+      {
+         using type = Node<Element, Lhs, Rhs, Operation>;
+         static const type& Make(const type& node) { return node; }
+      };
+      template <>
+      struct OperandOf<double>
+      {
+         using type = Scalar<double>;
+         static type Make(double value) { return type(value); }
+      };
+      // Quantities and every unit built on them, Meters becomes a Length
+      template <class T>
+         requires std::is_base_of_v<Quantity<typename T::dimension>, T>
+      struct OperandOf<T>
+      {
+         using type = Scalar<Quantity<typename T::dimension>>;
+         static type Make(const T& value) { return type(value); }
+      };
+
+      template <class T>
+      using Operand = typename OperandOf<std::remove_cvref_t<T>>::type;
+
+      // Operands of an array operator, anything OperandOf knows with at least
+      // one array or node so plain quantities keep their own operators
+      template <class Lhs, class Rhs>
+      concept Operands = requires { typename Operand<Lhs>; typename Operand<Rhs>; } && !(Operand<Lhs>::scalar && Operand<Rhs>::scalar);
+
+      // Element types of the results, the same types the scalar operators give
+      template <class Lhs, class Rhs>
+      struct SumOf
+      {
+         static_assert(std::is_same_v<Lhs, Rhs>, "only quantities of the same dimension can be added or subtracted");
+         using type = Lhs;
+      };
+
+      template <class Lhs, class Rhs>
+      struct ProductOf
+      {
+         using type = decltype(std::declval<Lhs>() * std::declval<Rhs>());
+      };
+      template <class Lhs>
+      struct ProductOf<Lhs, double>
+      {
+         using type = Lhs;
+      };
+      template <class Rhs>
+         requires (!std::is_same_v<Rhs, double>)
+      struct ProductOf<double, Rhs>
+      {
+         using type = Rhs;
+      };
+
+      template <class Lhs, class Rhs>
+      struct QuotientOf
+      {
+         using type = decltype(std::declval<Lhs>() / std::declval<Rhs>());
+      };
+      template <class Lhs>
+      struct QuotientOf<Lhs, double>
+      {
+         using type = Lhs;
+      };
+      template <class Rhs>
+         requires (!std::is_same_v<Rhs, double>)
+      struct QuotientOf<double, Rhs>
+      {
+         using type = Quantity<DimensionQuotient<Dimension<0, 0, 0, 0, 0>, typename Rhs::dimension>>;
+      };
+
+      template <class Element, class Operation, class Lhs, class Rhs>
+      auto MakeNode(const Lhs& lhs, const Rhs& rhs)
+      {
+         using LhsOperand = OperandOf<std::remove_cvref_t<Lhs>>;
+         using RhsOperand = OperandOf<std::remove_cvref_t<Rhs>>;
+         return Node<Element, typename LhsOperand::type, typename RhsOperand::type, Operation>(LhsOperand::Make(lhs), RhsOperand::Make(rhs));
+      }
+   } //end namespace ArrayExpressions
+
+   // Anything a QuantityArray of Element can be assigned from
+   template <class T, class Element>
+   concept ArrayExpressionOf = requires { typename ArrayExpressions::Operand<T>; }
+      && !ArrayExpressions::Operand<T>::scalar && std::is_same_v<typename ArrayExpressions::Operand<T>::element_type, Element>;
+
+   template <class Lhs, class Rhs>
+      requires ArrayExpressions::Operands<Lhs, Rhs>
+   auto operator+(const Lhs& lhs, const Rhs& rhs)
+   {
+      using Element = typename ArrayExpressions::SumOf<typename ArrayExpressions::Operand<Lhs>::element_type, typename ArrayExpressions::Operand<Rhs>::element_type>::type;
+      return ArrayExpressions::MakeNode<Element, ArrayExpressions::Add>(lhs, rhs);
+   }
+   template <class Lhs, class Rhs>
+      requires ArrayExpressions::Operands<Lhs, Rhs>
+   auto operator-(const Lhs& lhs, const Rhs& rhs)
+   {
+      using Element = typename ArrayExpressions::SumOf<typename ArrayExpressions::Operand<Lhs>::element_type, typename ArrayExpressions::Operand<Rhs>::element_type>::type;
+      return ArrayExpressions::MakeNode<Element, ArrayExpressions::Subtract>(lhs, rhs);
+   }
+   template <class Lhs, class Rhs>
+      requires ArrayExpressions::Operands<Lhs, Rhs>
+   auto operator*(const Lhs& lhs, const Rhs& rhs)
+   {
+      using Element = typename ArrayExpressions::ProductOf<typename ArrayExpressions::Operand<Lhs>::element_type, typename ArrayExpressions::Operand<Rhs>::element_type>::type;
+      return ArrayExpressions::MakeNode<Element, ArrayExpressions::Multiply>(lhs, rhs);
+   }
+   template <class Lhs, class Rhs>
+      requires ArrayExpressions::Operands<Lhs, Rhs>
+   auto operator/(const Lhs& lhs, const Rhs& rhs)
+   {
+      using Element = typename ArrayExpressions::QuotientOf<typename ArrayExpressions::Operand<Lhs>::element_type, typename ArrayExpressions::Operand<Rhs>::element_type>::type;
+      return ArrayExpressions::MakeNode<Element, ArrayExpressions::Divide>(lhs, rhs);
+   }
+} //end namespace Units
+
+#endif  // ARRAYEXPRESSION_H_GUARD
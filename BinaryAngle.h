@@ -0,0 +1,251 @@
+#ifndef BINARYANGLE_H_GUARD
+#define BINARYANGLE_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+
+#include "AngleType.h"
+#include "Trigonometry.h"
+#include "UnitBatch.h"
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Units
+{
+   // Representation holding an angle as an N bit binary angle (BAMS), the
+   // phase / 2^N of a full circle. Unsigned arithmetic wraps at a full
+   // circle, so every sum and difference is already normalized. As degrees
+   // a phase reads as signed, [-180, 180), and comparisons order phases as
+   // [0, 360).
+   template <class Unsigned>
+   struct BinaryAngle
+   {
+      static_assert(std::is_unsigned_v<Unsigned> && (std::numeric_limits<Unsigned>::digits >= 8), "binary angles must be unsigned integers of 8 bits or more");
+   };
+
+   template <class Rep>
+   inline constexpr bool IS_BINARY_ANGLE = false;
+   template <class Unsigned>
+   constexpr bool IS_BINARY_ANGLE<BinaryAngle<Unsigned>> = true;
+
+   template <class Unsigned>
+   struct Representation<BinaryAngle<Unsigned>>
+   {
+      using storage_type = Unsigned;
+      using value_type = double;
+      static constexpr bool floating = false;
+
+      static constexpr int BITS = std::numeric_limits<Unsigned>::digits;
+      using Signed = std::make_signed_t<Unsigned>;
+      // Products of narrow types would otherwise be done in (signed) int
+      using Wide = std::conditional_t<(BITS < 32), std::uint32_t, Unsigned>;
+
+      static constexpr Unsigned Add(Unsigned lhs, Unsigned rhs) { return Unsigned(lhs + rhs); }
+      static constexpr Unsigned Subtract(Unsigned lhs, Unsigned rhs) { return Unsigned(lhs - rhs); }
+      static constexpr Unsigned Negate(Unsigned value) { return Unsigned(Unsigned(0) - value); }
+
+      // Scaling by a whole number wraps too, the count is taken as signed
+      // (pass Unsigned(-2) to double and reverse)
+      static constexpr Unsigned Multiply(Unsigned lhs, Unsigned rhs) { return Unsigned(Wide(lhs) * Wide(rhs)); }
+      // Divides the signed phase by a signed count, truncating toward zero
+      static constexpr Unsigned Divide(Unsigned lhs, Unsigned rhs)
+      {
+         if (rhs == 0)
+         {
+            throw std::invalid_argument("Units::BinaryAngle division by zero");
+         }
+         if (Signed(rhs) == Signed(-1))
+         {
+            return Negate(lhs);
+         }
+         return Unsigned(Signed(Signed(lhs) / Signed(rhs)));
+      }
+
+      // Degrees in [-180, 180), exact for phases of up to 32 bits in double
+      template <class Floating>
+      static constexpr Floating ToFloating(Unsigned phase)
+      {
+         return Floating(Signed(phase)) * (Floating(360) / Floating(CIRCLE<Floating>));
+      }
+
+      // Nearest phase to any number of degrees. Whole circles are removed
+      // exactly below 10^15 degrees, NaN and infinity give 0.
+      template <class Floating>
+      static constexpr Unsigned FromFloating(Floating degrees)
+      {
+         if (!((degrees - degrees) == Floating(0)))
+         {
+            return Unsigned(0);
+         }
+
+         const Floating remainder = degrees - (Floating(360) * Nearest(degrees / Floating(360)));
+         Floating phase = Nearest(remainder * (Floating(CIRCLE<Floating>) / Floating(360)));
+         // Within a circle either side of zero, +-180 degrees is the same phase
+         if (phase >= (Floating(CIRCLE<Floating>) / Floating(2)))
+         {
+            phase -= Floating(CIRCLE<Floating>);
+         }
+         else if (phase < -(Floating(CIRCLE<Floating>) / Floating(2)))
+         {
+            phase += Floating(CIRCLE<Floating>);
+         }
+         return Unsigned(std::int64_t(phase));
+      }
+
+      // Between binary angles the phase is shifted, widening is exact and
+      // narrowing rounds to nearest. Other representations go through degrees.
+      template <class OtherRep>
+      static constexpr Unsigned Convert(typename Representation<OtherRep>::storage_type other)
+      {
+         using Other = Representation<OtherRep>;
+         if constexpr (IS_BINARY_ANGLE<OtherRep>)
+         {
+            using OtherUnsigned = typename Other::storage_type;
+            if constexpr (Other::BITS <= BITS)
+            {
+               return Unsigned(Unsigned(other) << (BITS - Other::BITS));
+            }
+            else
+            {
+               constexpr int SHIFT = Other::BITS - BITS;
+               return Unsigned(OtherUnsigned(other + (OtherUnsigned(1) << (SHIFT - 1))) >> SHIFT);
+            }
+         }
+         else if constexpr (Other::floating)
+         {
+            return FromFloating(other);
+         }
+         else
+         {
+            return FromFloating(Other::template ToFloating<long double>(other));
+         }
+      }
+
+   private:
+      // 2^BITS, as a floating point value
+      template <class Floating>
+      static constexpr Floating CIRCLE = Floating(2) * Floating(Unsigned(1) << (BITS - 1));
+
+      // Nearest whole number, halves away from zero. Anything as large as
+      // 2^62 has no fraction in the floating types used here.
+      template <class Floating>
+      static constexpr Floating Nearest(Floating value)
+      {
+         constexpr Floating LARGE = Floating(std::int64_t(1) << 62);
+         if ((value >= LARGE) || (value <= -LARGE))
+         {
+            return value;
+         }
+         std::int64_t whole = std::int64_t(value);
+         const Floating fraction = value - Floating(whole);
+         if (fraction >= Floating(0.5))
+         {
+            ++whole;
+         }
+         else if (fraction <= Floating(-0.5))
+         {
+            --whole;
+         }
+         return Floating(whole);
+      }
+   };
+
+   // Binary angles of 16, 32 and 64 bits, e.g. Bams16 steps are 360 / 65536
+   // degrees. Conversions to and from the double Angle are explicit:
+   //    Units::Bams32 heading(Units::Degrees(271.5));
+   //    Units::Angle degrees(heading);
+   using Bams16 = RepresentedAs<Angle, BinaryAngle<std::uint16_t>>;
+   using Bams32 = RepresentedAs<Angle, BinaryAngle<std::uint32_t>>;
+   using Bams64 = RepresentedAs<Angle, BinaryAngle<std::uint64_t>>;
+
+   template <class QuantityType>
+   concept BinaryAngleQuantity = std::is_same_v<typename QuantityType::dimension, Angle::dimension> &&
+      requires { typename QuantityType::storage_type; } &&
+      std::is_same_v<QuantityType, RepresentedAs<Angle, BinaryAngle<typename QuantityType::storage_type>>>;
+
+   // Sine and cosine of a binary angle within 2 ULP, 3 for Bams64 (see Trigonometry.h),
+   // the range reduction is exact integer arithmetic on the phase
+   template <BinaryAngleQuantity BinaryAngleType>
+   constexpr void SinCos(const BinaryAngleType& angle, double& sine, double& cosine)
+   {
+      using Unsigned = typename BinaryAngleType::storage_type;
+      Trigonometry::PhaseSinCos<double, Unsigned, Unsigned>(angle.Count(), sine, cosine);
+   }
+   template <BinaryAngleQuantity BinaryAngleType>
+   constexpr double Sin(const BinaryAngleType& angle)
+   {
+      double sine = 0.0;
+      double cosine = 0.0;
+      SinCos(angle, sine, cosine);
+      return sine;
+   }
+   template <BinaryAngleQuantity BinaryAngleType>
+   constexpr double Cos(const BinaryAngleType& angle)
+   {
+      double sine = 0.0;
+      double cosine = 0.0;
+      SinCos(angle, sine, cosine);
+      return cosine;
+   }
+
+   // Nearest binary angle to atan2(y, x), Units::Atan2<Units::Bams32>(north, east).
+   // (0, 0) and NaN give 0.
+   template <BinaryAngleQuantity BinaryAngleType>
+   constexpr BinaryAngleType Atan2(double y, double x)
+   {
+      using Unsigned = typename BinaryAngleType::storage_type;
+      double radians = 0.0;
+      Unsigned phase = 0;
+      Trigonometry::Atan2(y, x, radians);
+      Trigonometry::RadiansToPhase<Unsigned, Unsigned>(radians, phase);
+      return BinaryAngleType::FromCount(phase);
+   }
+
+   // Batch versions on the SIMD kernels of UnitBatch.h, e.g.
+   // Units::SinCos<Units::Bams32>(headings, sines, cosines). Either output of
+   // SinCos may be empty when it is not wanted.
+   template <BinaryAngleQuantity BinaryAngleType>
+   void SinCos(std::span<const BinaryAngleType> angles, std::span<double> sines, std::span<double> cosines)
+   {
+      using Unsigned = typename BinaryAngleType::storage_type;
+      PhaseSinCos(std::span<const Unsigned>(reinterpret_cast<const Unsigned*>(angles.data()), angles.size()), sines, cosines);
+   }
+   template <BinaryAngleQuantity BinaryAngleType>
+   void Sin(std::span<const BinaryAngleType> angles, std::span<double> sines)
+   {
+      SinCos<BinaryAngleType>(angles, sines, std::span<double>());
+   }
+   template <BinaryAngleQuantity BinaryAngleType>
+   void Cos(std::span<const BinaryAngleType> angles, std::span<double> cosines)
+   {
+      SinCos<BinaryAngleType>(angles, std::span<double>(), cosines);
+   }
+   template <BinaryAngleQuantity BinaryAngleType>
+   void Atan2(std::span<const double> y, std::span<const double> x, std::span<BinaryAngleType> angles)
+   {
+      using Unsigned = typename BinaryAngleType::storage_type;
+      PhaseAtan2(y, x, std::span<Unsigned>(reinterpret_cast<Unsigned*>(angles.data()), angles.size()));
+   }
+} //end namespace Units
+
+static_assert(sizeof(Units::Bams16) == sizeof(std::uint16_t) && std::is_trivially_copyable_v<Units::Bams16>, "Bams16 must be a bare uint16_t");
+static_assert(sizeof(Units::Bams32) == sizeof(std::uint32_t) && std::is_trivially_copyable_v<Units::Bams32>, "Bams32 must be a bare uint32_t");
+static_assert(sizeof(Units::Bams64) == sizeof(std::uint64_t) && std::is_trivially_copyable_v<Units::Bams64>, "Bams64 must be a bare uint64_t");
+
+#endif  // BINARYANGLE_H_GUARD
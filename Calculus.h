@@ -0,0 +1,303 @@
+#ifndef CALCULUS_H_GUARD
+#define CALCULUS_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include "AngleMath.h"
+#include "AngleType.h"
+#include "ArrayExpression.h"
+#include "QuantityArray.h"
+#include "TimeType.h"
+#include "UnitParallel.h"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Units
+{
+   namespace Calculus
+   {
+      // Length gives Speed, Speed gives Acceleration, Angle gives AngularSpeed
+      template <class Element>
+      using RateOf = typename ArrayExpressions::QuotientOf<Element, Time>::type;
+      // Power gives Energy
+      template <class Element>
+      using IntegralOf = typename ArrayExpressions::ProductOf<Element, Time>::type;
+
+      // lhs - rhs, the shortest turn for angles so a heading crossing north
+      // changes by a few degrees instead of almost a full circle
+      template <class Element>
+      constexpr Element Difference(const Element& lhs, const Element& rhs)
+      {
+         if constexpr (std::is_same_v<Element, Angle>)
+         {
+            return CircularDifference(lhs, rhs);
+         }
+         else
+         {
+            return lhs - rhs;
+         }
+      }
+
+      constexpr Time HalfOf(const Time& dt)
+      {
+         return Seconds(0.5 * Seconds(dt).value());
+      }
+
+      inline void CheckStreams(std::size_t first, std::size_t count, std::size_t streams, const char* error)
+      {
+         if ((first > streams) || (count > (streams - first)))
+         {
+            throw std::invalid_argument(error);
+         }
+      }
+   } //end namespace Calculus
+
+   // Rates of change of many streams sampled once a frame, such as the
+   // position of every entity, replacing a function static that holds the
+   // previous sample of a single stream. The previous sample and rate of
+   // every stream sit in two contiguous arrays and stream i is only read and
+   // written at index i, so threads updating disjoint ranges of streams
+   // need no locks. One Update of a range at a time.
+   //    Differentiator<Length> motion(entities);
+   //    motion.Update(positions, frameTime, speeds, accelerations);
+   // A stream's first sample gives a zero rate and its first rate a zero
+   // change of rate, rather than a jump from nothing. A NaN sample gives NaN
+   // and starts the stream over. Angle streams are differenced across the
+   // 0 / 360 seam.
+   template <class Element>
+   class Differentiator
+   {
+   public:
+      using rate_type = Calculus::RateOf<Element>;
+      using change_type = Calculus::RateOf<rate_type>;
+
+      Differentiator() = default;
+      explicit Differentiator(std::size_t streams, ArrayMemory memory = ArrayMemory::Aligned) : m_previous(streams, memory), m_rates(streams, memory)
+      {
+         Reset();
+      }
+
+      std::size_t size() const { return m_previous.size(); }
+
+      // rates[i] = (samples[i] - previous sample) / dt for streams
+      // [first, first + samples.size()). Throws std::invalid_argument when
+      // the streams are out of range or rates is smaller than samples.
+      void Update(std::span<const Element> samples, Time dt, std::span<rate_type> rates, std::size_t first = 0)
+      {
+         Update(nullptr, samples, dt, rates, std::span<change_type>(), first);
+      }
+      // Also changes[i] = (rates[i] - previous rate) / dt, the second
+      // difference (Acceleration for Length)
+      void Update(std::span<const Element> samples, Time dt, std::span<rate_type> rates, std::span<change_type> changes, std::size_t first = 0)
+      {
+         Update(nullptr, samples, dt, rates, changes, first);
+      }
+      // As above across a thread pool, or with a standard execution policy
+      // (UnitExecution.h)
+      void Update(ThreadPool& pool, std::span<const Element> samples, Time dt, std::span<rate_type> rates, std::span<change_type> changes = {},
+         std::size_t first = 0)
+      {
+         Update(&pool, samples, dt, rates, changes, first);
+      }
+      template <Parallel::ExecutionPolicy Policy>
+      void Update(Policy&& policy, std::span<const Element> samples, Time dt, std::span<rate_type> rates, std::span<change_type> changes = {},
+         std::size_t first = 0)
+      {
+         Update(Parallel::PoolOf(policy), samples, dt, rates, changes, first);
+      }
+
+      // Forgets the history of one stream, e.g. when its entity is reused
+      void Reset(std::size_t stream)
+      {
+         Calculus::CheckStreams(stream, 1, size(), "Units::Differentiator stream out of range");
+         m_previous.Values()[stream] = NO_SAMPLE;
+         m_rates.Values()[stream] = NO_SAMPLE;
+      }
+      void Reset()
+      {
+         std::fill(m_previous.Values().begin(), m_previous.Values().end(), NO_SAMPLE);
+         std::fill(m_rates.Values().begin(), m_rates.Values().end(), NO_SAMPLE);
+      }
+
+   private:
+      static constexpr double NO_SAMPLE = std::numeric_limits<double>::quiet_NaN();
+
+      void Update(ThreadPool* pool, std::span<const Element> samples, Time dt, std::span<rate_type> rates, std::span<change_type> changes, std::size_t first)
+      {
+         Calculus::CheckStreams(first, samples.size(), size(), "Units::Differentiator streams out of range");
+         if ((rates.size() < samples.size()) || (!changes.empty() && (changes.size() < samples.size())))
+         {
+            throw std::invalid_argument("Units::Differentiator output is smaller than samples");
+         }
+
+         Element* const previous = m_previous.begin() + first;
+         rate_type* const previousRates = m_rates.begin() + first;
+         Parallel::ForEach(pool, samples.size(), Parallel::ChunkOf(5 * sizeof(double)), [&](std::size_t begin, std::size_t end)
+         {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+               // Without a previous sample the previous rate is NaN as well,
+               // from Reset or from the NaN sample that started the stream over
+               const bool started = (previous[i] == previous[i]);
+               const rate_type rate = started ? (Calculus::Difference(samples[i], previous[i]) / dt) : rate_type::zero();
+               if (!changes.empty())
+               {
+                  changes[i] = (previousRates[i] == previousRates[i]) ? ((rate - previousRates[i]) / dt) : change_type::zero();
+               }
+               rates[i] = rate;
+               previousRates[i] = started ? rate : previousRates[i];
+               previous[i] = samples[i];
+            }
+         });
+      }
+
+      QuantityArray<Element> m_previous;
+      QuantityArray<rate_type> m_rates;
+   };
+
+   // Running trapezoid rule integrals of many streams sampled once a frame,
+   // such as the energy each of many loads has used from their power. The
+   // same layout and threading rules as Differentiator.
+   //    Accumulator<Power> energy(loads);
+   //    energy.Update(power, frameTime);
+   //    Energy used = energy.Totals()[i];
+   // A stream's first sample adds nothing, every later one adds
+   // (previous + sample) / 2 * dt. A NaN sample starts the stream over
+   // without losing its total.
+   template <class Element>
+   class Accumulator
+   {
+   public:
+      using total_type = Calculus::IntegralOf<Element>;
+
+      Accumulator() = default;
+      explicit Accumulator(std::size_t streams, ArrayMemory memory = ArrayMemory::Aligned) : m_previous(streams, memory), m_totals(streams, memory)
+      {
+         Reset();
+      }
+
+      std::size_t size() const { return m_previous.size(); }
+
+      // Adds the interval since the previous sample for streams
+      // [first, first + samples.size()). Throws std::invalid_argument when
+      // the streams are out of range.
+      void Update(std::span<const Element> samples, Time dt, std::size_t first = 0) { Update(nullptr, samples, dt, first); }
+      void Update(ThreadPool& pool, std::span<const Element> samples, Time dt, std::size_t first = 0) { Update(&pool, samples, dt, first); }
+      template <Parallel::ExecutionPolicy Policy>
+      void Update(Policy&& policy, std::span<const Element> samples, Time dt, std::size_t first = 0)
+      {
+         Update(Parallel::PoolOf(policy), samples, dt, first);
+      }
+
+      std::span<const total_type> Totals() const { return m_totals.Elements(); }
+
+      // Zeroes the total and forgets the previous sample of one stream
+      void Reset(std::size_t stream)
+      {
+         Calculus::CheckStreams(stream, 1, size(), "Units::Accumulator stream out of range");
+         m_previous.Values()[stream] = NO_SAMPLE;
+         m_totals[stream] = total_type::zero();
+      }
+      void Reset()
+      {
+         std::fill(m_previous.Values().begin(), m_previous.Values().end(), NO_SAMPLE);
+         std::fill(m_totals.begin(), m_totals.end(), total_type::zero());
+      }
+
+   private:
+      static constexpr double NO_SAMPLE = std::numeric_limits<double>::quiet_NaN();
+
+      void Update(ThreadPool* pool, std::span<const Element> samples, Time dt, std::size_t first)
+      {
+         Calculus::CheckStreams(first, samples.size(), size(), "Units::Accumulator streams out of range");
+
+         const Time halfStep = Calculus::HalfOf(dt);
+         Element* const previous = m_previous.begin() + first;
+         total_type* const totals = m_totals.begin() + first;
+         Parallel::ForEach(pool, samples.size(), Parallel::ChunkOf(3 * sizeof(double)), [&](std::size_t begin, std::size_t end)
+         {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+               const total_type area = (previous[i] + samples[i]) * halfStep;
+               totals[i] += (area == area) ? area : total_type::zero();
+               previous[i] = samples[i];
+            }
+         });
+      }
+
+      QuantityArray<Element> m_previous;
+      QuantityArray<total_type> m_totals;
+   };
+
+   // One stream sampled every dt, rates[i] = (series[i + 1] - series[i]) / dt,
+   // one rate fewer than samples. Throws std::invalid_argument if rates is
+   // too small.
+   template <class Element>
+   void Differences(std::span<const Element> series, Time dt, std::span<Calculus::RateOf<Element>> rates)
+   {
+      const std::size_t count = (series.size() > 1) ? (series.size() - 1) : 0;
+      if (rates.size() < count)
+      {
+         throw std::invalid_argument("Units::Differences output is smaller than the series");
+      }
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         rates[i] = Calculus::Difference(series[i + 1], series[i]) / dt;
+      }
+   }
+
+   // Trapezoid rule integral of one stream sampled every dt, zero for fewer
+   // than two samples
+   template <class Element>
+   Calculus::IntegralOf<Element> TrapezoidIntegral(std::span<const Element> samples, Time dt)
+   {
+      const Time halfStep = Calculus::HalfOf(dt);
+      Calculus::IntegralOf<Element> total = Calculus::IntegralOf<Element>::zero();
+      for (std::size_t i = 1; i < samples.size(); ++i)
+      {
+         total += (samples[i - 1] + samples[i]) * halfStep;
+      }
+      return total;
+   }
+
+   // totals[i] = TrapezoidIntegral of samples[0] to samples[i], totals[0] is
+   // zero. Throws std::invalid_argument if totals is smaller than samples.
+   template <class Element>
+   void CumulativeTrapezoid(std::span<const Element> samples, Time dt, std::span<Calculus::IntegralOf<Element>> totals)
+   {
+      if (totals.size() < samples.size())
+      {
+         throw std::invalid_argument("Units::CumulativeTrapezoid output is smaller than samples");
+      }
+      const Time halfStep = Calculus::HalfOf(dt);
+      Calculus::IntegralOf<Element> total = Calculus::IntegralOf<Element>::zero();
+      for (std::size_t i = 0; i < samples.size(); ++i)
+      {
+         if (i > 0)
+         {
+            total += (samples[i - 1] + samples[i]) * halfStep;
+         }
+         totals[i] = total;
+      }
+   }
+} //end namespace Units
+
+#endif  // CALCULUS_H_GUARD
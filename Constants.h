@@ -0,0 +1,67 @@
+#ifndef CONSTANTS_H_GUARD
+#define CONSTANTS_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "AccelerationType.h"
+#include "AngularSpeedType.h"
+#include "AreaType.h"
+#include "DensityType.h"
+#include "EnergyType.h"
+#include "LengthType.h"
+#include "MassType.h"
+#include "PowerType.h"
+#include "PressureType.h"
+#include "SpeedType.h"
+#include "TemperatureType.h"
+#include "TimeType.h"
+#include "VolumeType.h"
+
+// Physical constants as typed quantities. Each is inline constexpr, one
+// object for the program that is constant initialized, so no translation
+// unit gets a dynamic initializer for them.
+// SI defining constants are exact (https://physics.nist.gov/cuu/Constants/),
+// the others are CODATA 2018 recommended values.
+namespace Units
+{
+   namespace Constants
+   {
+      using Units::SPEED_OF_LIGHT;
+      inline constexpr Acceleration STANDARD_GRAVITY = StandardGravity(1.0);
+      inline constexpr Pressure STANDARD_ATMOSPHERE = Atmospheres(1.0);
+
+      // J/K
+      inline constexpr auto BOLTZMANN = Joules(1.380649e-23) / Kelvin(1.0);
+      // J s
+      inline constexpr auto PLANCK = Joules(6.62607015e-34) * Seconds(1.0);
+      // W/(m^2 K^4)
+      inline constexpr auto STEFAN_BOLTZMANN = Watts(5.670374419e-8) / (SquareMeters(1.0) * (Kelvin(1.0) * Kelvin(1.0)) * (Kelvin(1.0) * Kelvin(1.0)));
+      // m^3/(kg s^2)
+      inline constexpr auto GRAVITATIONAL = CubicMeters(6.67430e-11) / (Kilograms(1.0) * (Seconds(1.0) * Seconds(1.0)));
+
+      // International Standard Atmosphere at mean sea level
+      inline constexpr Temperature STANDARD_TEMPERATURE = Kelvin(288.15);
+      inline constexpr Density STANDARD_DENSITY = KilogramsPerCubicMeter(1.225);
+      // J/(kg K), dry air
+      inline constexpr auto SPECIFIC_GAS_CONSTANT_AIR = Joules(287.05287) / (Kilograms(1.0) * Kelvin(1.0));
+
+      // WGS 84
+      inline constexpr Length EARTH_EQUATORIAL_RADIUS = Meters(6378137.0);
+      inline constexpr AngularSpeed EARTH_ROTATION_RATE = RadiansPerSecond(7.292115e-5);
+   } //end namespace Constants
+} //end namespace Units
+
+#endif  // CONSTANTS_H_GUARD
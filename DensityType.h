@@ -20,23 +20,14 @@ limitations under the License.
 
 namespace Units
 {
-   class Mass;
-   class Volume;
-
-   class Density
-   {
-   public:
-
-      Mass operator*(const Volume& volume) const;
-
-      GENERIC_OPERATORS(Density);
-   };
+   // Base unit is kilograms per cubic meter
+   using Density = Quantity<Dimension<-3, 1, 0, 0, 0>>;
 } //end namespace Units
 
 UNIT_TEMPLATE(Density, KilogramsPerCubicMeter, 1.0, kg_m3);
-UNIT_TEMPLATE(Density, KilogramsPerLiter, 0.001, kg_L);
-UNIT_TEMPLATE(Density, GramsPerCubicCentimeter, (0.001), g_cm3);
-UNIT_TEMPLATE(Density, GramsPerMilliliter, (0.001), g_mL);
-UNIT_TEMPLATE(Density, TonnesPerCubicMeter, (1/1000), t_m3); // 1000 Kg per Tonne
+UNIT_TEMPLATE(Density, KilogramsPerLiter, 1000.0, kg_L); // 1000 L per m^3
+UNIT_TEMPLATE(Density, GramsPerCubicCentimeter, (1000.0), g_cm3);
+UNIT_TEMPLATE(Density, GramsPerMilliliter, (1000.0), g_mL);
+UNIT_TEMPLATE(Density, TonnesPerCubicMeter, (1000.0), t_m3); // 1000 Kg per Tonne
 
 #endif  // DENSITYTYPE_H_GUARD
@@ -0,0 +1,44 @@
+#ifndef ENERGYTYPE_H_GUARD
+#define ENERGYTYPE_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include <ratio>
+
+namespace Units
+{
+   // Base unit is joules, N * m
+   using Energy = Quantity<Dimension<2, 1, -2, 0, 0>>;
+} //end namespace Units
+
+//https://www.nist.gov/pml/special-publication-811/nist-guide-si-appendix-b-conversion-factors/nist-guide-si-appendix-b8
+UNIT_TEMPLATE(Energy, WattHours, 3600.0, Wh); // 3600 seconds per hour
+UNIT_TEMPLATE(Energy, KilowattHours, 3600000.0, kWh);
+UNIT_TEMPLATE(Energy, Calories, 4.184, cal); // thermochemical calorie
+UNIT_TEMPLATE(Energy, Kilocalories, 4184.0, kcal);
+UNIT_TEMPLATE(Energy, BritishThermalUnits, 1055.05585262, BTU); // International Table BTU
+UNIT_TEMPLATE(Energy, FootPounds, (0.3048 * 4.4482216152605), ft_lbF); // foot * pound-force
+UNIT_TEMPLATE(Energy, ElectronVolts, 1.602176634E-19, eV); // exact since the 2019 SI redefinition
+
+//Metric
+UNIT_TEMPLATE_RATIO(Energy, GigaJoules, std::giga::num, std::giga::den, GJ);
+UNIT_TEMPLATE_RATIO(Energy, MegaJoules, std::mega::num, std::mega::den, MJ);
+UNIT_TEMPLATE_RATIO(Energy, KiloJoules, std::kilo::num, std::kilo::den, kJ);
+UNIT_TEMPLATE_RATIO(Energy, Joules, 1, 1, J);
+UNIT_TEMPLATE_RATIO(Energy, MilliJoules, std::milli::num, std::milli::den, mJ);
+
+#endif  // ENERGYTYPE_H_GUARD
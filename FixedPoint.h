@@ -0,0 +1,233 @@
+#ifndef FIXEDPOINT_H_GUARD
+#define FIXEDPOINT_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include <cstdint>
+#include <limits>
+#include <ratio>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace Units
+{
+   // What fixed point arithmetic does when a result does not fit
+   enum class Overflow
+   {
+      Saturate,   // clamp to the largest or smallest count
+      Checked     // throw std::overflow_error
+   };
+
+   // Representation holding a quantity as a whole number of Scale base units,
+   // e.g. Time as FixedPoint<std::int64_t, std::nano> counts nanoseconds.
+   // Adding and subtracting are exact integer operations, conversions from
+   // floating point representations round to the nearest count.
+   template <class Integer, class Scale = std::ratio<1>, Overflow Mode = Overflow::Saturate>
+   struct FixedPoint
+   {
+      static_assert(std::is_integral_v<Integer> && std::is_signed_v<Integer>, "fixed point counts must be signed integers");
+      static_assert(Scale::num > 0, "fixed point scale must be positive");
+   };
+
+   template <class Rep>
+   inline constexpr bool IS_FIXED_POINT = false;
+   template <class Integer, class Scale, Overflow Mode>
+   constexpr bool IS_FIXED_POINT<FixedPoint<Integer, Scale, Mode>> = true;
+
+   template <class Integer, class Scale, Overflow Mode>
+   struct Representation<FixedPoint<Integer, Scale, Mode>>
+   {
+      using storage_type = Integer;
+      using value_type = double;
+      using scale = Scale;
+      static constexpr bool floating = false;
+
+      static constexpr Integer MAX = std::numeric_limits<Integer>::max();
+      static constexpr Integer MIN = std::numeric_limits<Integer>::min();
+
+      static constexpr Integer Overflowed(bool positive)
+      {
+         if constexpr (Mode == Overflow::Checked)
+         {
+            throw std::overflow_error("Units::FixedPoint overflow");
+         }
+         return positive ? MAX : MIN;
+      }
+
+      static constexpr Integer Add(Integer lhs, Integer rhs)
+      {
+         Integer result = 0;
+         return __builtin_add_overflow(lhs, rhs, &result) ? Overflowed(rhs > 0) : result;
+      }
+      static constexpr Integer Subtract(Integer lhs, Integer rhs)
+      {
+         Integer result = 0;
+         return __builtin_sub_overflow(lhs, rhs, &result) ? Overflowed(rhs < 0) : result;
+      }
+      static constexpr Integer Negate(Integer value)
+      {
+         return (value == MIN) ? Overflowed(true) : Integer(-value);
+      }
+      static constexpr Integer Multiply(Integer lhs, Integer rhs)
+      {
+         Integer result = 0;
+         return __builtin_mul_overflow(lhs, rhs, &result) ? Overflowed((lhs < 0) == (rhs < 0)) : result;
+      }
+      // Truncates toward zero like integer division, dividing by zero is an
+      // overflow toward the sign of lhs (zero for 0 / 0)
+      static constexpr Integer Divide(Integer lhs, Integer rhs)
+      {
+         if (rhs == 0)
+         {
+            return (lhs == 0) ? Integer(0) : Overflowed(lhs > 0);
+         }
+         return ((lhs == MIN) && (rhs == -1)) ? Overflowed(true) : Integer(lhs / rhs);
+      }
+
+      template <class Floating>
+      static constexpr Floating ToFloating(Integer count)
+      {
+         if constexpr (Scale::den == 1)
+         {
+            return Floating(count) * Floating(Scale::num);
+         }
+         else if constexpr (Scale::num == 1)
+         {
+            return Floating(count) / Floating(Scale::den);
+         }
+         else
+         {
+            return Floating(count) * (Floating(Scale::num) / Floating(Scale::den));
+         }
+      }
+
+      // Nearest count, NaN is an overflow toward zero (zero when saturating)
+      template <class Floating>
+      static constexpr Integer FromFloating(Floating value)
+      {
+         Floating counts = value;
+         if constexpr (Scale::num == 1)
+         {
+            counts = value * Floating(Scale::den);
+         }
+         else if constexpr (Scale::den == 1)
+         {
+            counts = value / Floating(Scale::num);
+         }
+         else
+         {
+            counts = value * (Floating(Scale::den) / Floating(Scale::num));
+         }
+
+         // -MIN is a power of two and exact in any floating type
+         if (!(counts == counts))
+         {
+            return (Mode == Overflow::Checked) ? Overflowed(true) : Integer(0);
+         }
+         if (counts >= -Floating(MIN))
+         {
+            return Overflowed(true);
+         }
+         if (counts < Floating(MIN))
+         {
+            return Overflowed(false);
+         }
+
+         Integer count = Integer(counts);
+         const Floating remainder = counts - Floating(count);
+         if ((remainder >= Floating(0.5)) && (count != MAX))
+         {
+            ++count;
+         }
+         else if ((remainder <= Floating(-0.5)) && (count != MIN))
+         {
+            --count;
+         }
+         return count;
+      }
+
+      template <class Other>
+      static constexpr Integer Narrow(Other value)
+      {
+         return std::in_range<Integer>(value) ? Integer(value) : Overflowed(value > 0);
+      }
+
+      // Between fixed point scales with whole number ratios the count is
+      // rescaled exactly (rounded to nearest when dividing), other ratios
+      // and floating point representations go through long double
+      template <class OtherRep>
+      static constexpr Integer Convert(typename Representation<OtherRep>::storage_type other)
+      {
+         using Other = Representation<OtherRep>;
+         if constexpr (IS_FIXED_POINT<OtherRep>)
+         {
+            using Ratio = std::ratio_divide<typename Other::scale, Scale>;
+            if constexpr (Ratio::den == 1)
+            {
+               if constexpr (!std::in_range<Integer>(Ratio::num))
+               {
+                  return (other == 0) ? Integer(0) : Overflowed(other > 0);
+               }
+               else
+               {
+                  return Multiply(Narrow(other), Integer(Ratio::num));
+               }
+            }
+            else if constexpr (Ratio::num == 1)
+            {
+               using OtherInteger = typename Other::storage_type;
+               if constexpr (!std::in_range<OtherInteger>(Ratio::den))
+               {
+                  // Every count is below half of the divisor
+                  return Integer(0);
+               }
+               else
+               {
+                  constexpr OtherInteger DIVISOR = OtherInteger(Ratio::den);
+                  OtherInteger quotient = OtherInteger(other / DIVISOR);
+                  const OtherInteger remainder = OtherInteger(other % DIVISOR);
+                  // |remainder| >= DIVISOR / 2 without overflowing
+                  if ((remainder > 0) && (remainder >= (DIVISOR - remainder)))
+                  {
+                     ++quotient;
+                  }
+                  else if ((remainder < 0) && (-remainder >= (DIVISOR + remainder)))
+                  {
+                     --quotient;
+                  }
+                  return Narrow(quotient);
+               }
+            }
+            else
+            {
+               return FromFloating(Other::template ToFloating<long double>(other));
+            }
+         }
+         else if constexpr (Other::floating)
+         {
+            return FromFloating(typename Other::storage_type(other));
+         }
+         else
+         {
+            return FromFloating(Other::template ToFloating<long double>(other));
+         }
+      }
+   };
+} //end namespace Units
+
+#endif  // FIXEDPOINT_H_GUARD
@@ -0,0 +1,109 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#ifndef KINEMATICS_CPP_GUARD
+#define KINEMATICS_CPP_GUARD
+
+#include "Kinematics.h"
+#include <algorithm>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+namespace Units
+{
+   namespace Kinematics
+   {
+      UNITS_INLINE void Restart(Vec3Array<Acceleration>& accelerations, std::size_t first, std::size_t count)
+      {
+         const std::size_t size = accelerations.size();
+         if ((first > size) || (count > (size - first)))
+         {
+            throw std::invalid_argument("Units::KinematicState entities out of range");
+         }
+         constexpr double NO_STEP = std::numeric_limits<double>::quiet_NaN();
+         for (QuantityArray<Acceleration>* component : { &accelerations.x, &accelerations.y, &accelerations.z })
+         {
+            const std::span<double> values = component->Values().subspan(first, count);
+            std::fill(values.begin(), values.end(), NO_STEP);
+         }
+      }
+
+      inline void IntegrateAxis(QuantityArray<Length>& position, QuantityArray<Speed>& velocity, const QuantityArray<Acceleration>& acceleration,
+         QuantityArray<Acceleration>& previous, std::size_t begin, std::size_t end, double dt, Integrator integrator, BatchKernel kernel)
+      {
+         const std::size_t count = end - begin;
+         IntegrateMotion(position.Values().subspan(begin, count), velocity.Values().subspan(begin, count),
+            acceleration.Values().subspan(begin, count), previous.Values().subspan(begin, count), dt, integrator, kernel);
+      }
+
+      inline void CheckState(const KinematicState& state)
+      {
+         const std::size_t count = state.size();
+         const Vec3Array<Length>& position = state.position;
+         const Vec3Array<Speed>& velocity = state.velocity;
+         const Vec3Array<Acceleration>& acceleration = state.acceleration;
+         const Vec3Array<Acceleration>& previous = state.previousAcceleration;
+         if ((position.x.size() != count) || (position.y.size() != count) || (position.z.size() != count) ||
+            (velocity.x.size() != count) || (velocity.y.size() != count) || (velocity.z.size() != count) ||
+            (acceleration.x.size() != count) || (acceleration.y.size() != count) || (acceleration.z.size() != count) ||
+            (previous.x.size() != count) || (previous.y.size() != count) || (previous.z.size() != count))
+         {
+            throw std::invalid_argument("Units::KinematicState arrays differ in size");
+         }
+      }
+
+      UNITS_INLINE void Integrate(ThreadPool* pool, KinematicState& state, Time dt, Integrator integrator)
+      {
+         CheckState(state);
+         const std::size_t count = state.size();
+         const double seconds = Seconds(dt).value();
+         const BatchKernel kernel = SupportedBatchKernel();
+         // An entity is one double in each of the nine arrays, twelve for Verlet
+         const std::size_t entityBytes = ((integrator == Integrator::Verlet) ? 12 : 9) * sizeof(double);
+         Parallel::ForEach(pool, count, Parallel::ChunkOf(entityBytes), [&](std::size_t begin, std::size_t end)
+         {
+            IntegrateAxis(state.position.x, state.velocity.x, state.acceleration.x, state.previousAcceleration.x, begin, end, seconds, integrator, kernel);
+            IntegrateAxis(state.position.y, state.velocity.y, state.acceleration.y, state.previousAcceleration.y, begin, end, seconds, integrator, kernel);
+            IntegrateAxis(state.position.z, state.velocity.z, state.acceleration.z, state.previousAcceleration.z, begin, end, seconds, integrator, kernel);
+         });
+      }
+
+      inline void FinishAxis(QuantityArray<Speed>& velocity, const QuantityArray<Acceleration>& acceleration, QuantityArray<Acceleration>& previous,
+         std::size_t begin, std::size_t end, double dt, BatchKernel kernel)
+      {
+         const std::size_t count = end - begin;
+         FinishVerlet(velocity.Values().subspan(begin, count), acceleration.Values().subspan(begin, count), previous.Values().subspan(begin, count),
+            dt, kernel);
+      }
+
+      UNITS_INLINE void Finish(ThreadPool* pool, KinematicState& state, Time dt)
+      {
+         CheckState(state);
+         const double seconds = Seconds(dt).value();
+         const BatchKernel kernel = SupportedBatchKernel();
+         // An entity is one double in each of the nine arrays read or written
+         Parallel::ForEach(pool, state.size(), Parallel::ChunkOf(9 * sizeof(double)), [&](std::size_t begin, std::size_t end)
+         {
+            FinishAxis(state.velocity.x, state.acceleration.x, state.previousAcceleration.x, begin, end, seconds, kernel);
+            FinishAxis(state.velocity.y, state.acceleration.y, state.previousAcceleration.y, begin, end, seconds, kernel);
+            FinishAxis(state.velocity.z, state.acceleration.z, state.previousAcceleration.z, begin, end, seconds, kernel);
+         });
+      }
+   } //end namespace Kinematics
+} //end namespace Units
+
+#endif  // KINEMATICS_CPP_GUARD
@@ -0,0 +1,119 @@
+#ifndef KINEMATICS_H_GUARD
+#define KINEMATICS_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include "AccelerationType.h"
+#include "LengthType.h"
+#include "SpeedType.h"
+#include "TimeType.h"
+#include "UnitBatch.h"
+#include "UnitParallel.h"
+#include "Vec3.h"
+#include <cstddef>
+
+namespace Units
+{
+   namespace Kinematics
+   {
+      // Sets the accelerations of entities [first, first + count) to NaN.
+      // Throws std::invalid_argument when they are out of range.
+      UNITS_INLINE void Restart(Vec3Array<Acceleration>& accelerations, std::size_t first, std::size_t count);
+   } //end namespace Kinematics
+
+   // Position, velocity and acceleration of many entities, one Vec3Array
+   // each, so every component is a separate aligned array of base unit
+   // doubles. Entity i is position[i], velocity[i] and acceleration[i].
+   // previousAcceleration is the acceleration of the last Verlet step, NaN
+   // until an entity has had one.
+   class KinematicState
+   {
+   public:
+      KinematicState() = default;
+      explicit KinematicState(std::size_t count, ArrayMemory memory = ArrayMemory::Aligned)
+         : position(count, memory), velocity(count, memory), acceleration(count, memory), previousAcceleration(count, memory)
+      {
+         RestartVerlet();
+      }
+
+      std::size_t size() const { return position.size(); }
+
+      // Forgets the previous accelerations, so the next Verlet step starts
+      // over from the velocities as they are. Call it after stepping with
+      // another integrator, or after setting velocities directly.
+      void RestartVerlet()
+      {
+         RestartVerlet(0, size());
+      }
+      void RestartVerlet(std::size_t first, std::size_t count)
+      {
+         Kinematics::Restart(previousAcceleration, first, count);
+      }
+
+      Vec3Array<Length> position;
+      Vec3Array<Speed> velocity;
+      Vec3Array<Acceleration> acceleration;
+      Vec3Array<Acceleration> previousAcceleration;
+   };
+
+   namespace Kinematics
+   {
+      // Steps every entity on pool, or on the calling thread for nullptr.
+      // Throws std::invalid_argument if the arrays differ in size.
+      UNITS_INLINE void Integrate(ThreadPool* pool, KinematicState& state, Time dt, Integrator integrator);
+      // FinishVerlet on pool, or on the calling thread for nullptr
+      UNITS_INLINE void Finish(ThreadPool* pool, KinematicState& state, Time dt);
+   } //end namespace Kinematics
+
+   // Advances positions and velocities by dt with the accelerations in the
+   // state (see Integrator in UnitBatch.h), which Verlet keeps in
+   // previousAcceleration for the next step. Set the accelerations for the
+   // current positions before every step. Each thread takes a range of
+   // entities and steps its x, y and z components on the batch kernels,
+   // reading and writing every array once, and the result is the same bits
+   // for any thread count or kernel. Execution policies need UnitExecution.h.
+   //    Units::Integrate(pool, state, Units::Seconds(1.0 / 60.0), Units::Integrator::SemiImplicitEuler);
+   inline void Integrate(KinematicState& state, Time dt, Integrator integrator) { Kinematics::Integrate(nullptr, state, dt, integrator); }
+   inline void Integrate(ThreadPool& pool, KinematicState& state, Time dt, Integrator integrator) { Kinematics::Integrate(&pool, state, dt, integrator); }
+   template <Parallel::ExecutionPolicy Policy>
+   void Integrate(Policy&& policy, KinematicState& state, Time dt, Integrator integrator)
+   {
+      Kinematics::Integrate(Parallel::PoolOf(policy), state, dt, integrator);
+   }
+
+   // After Verlet steps the velocities are those at the start of the last
+   // step. With the accelerations set for the current positions, this
+   // brings them up to the positions (see FinishVerlet in UnitBatch.h), for
+   // reading or for switching integrators. Stepping on with Verlet gives the
+   // same bits as without finishing. dt is that of the last step.
+   //    Units::Integrate(pool, state, frameTime, Units::Integrator::Verlet);
+   //    ...set state.acceleration for the new positions
+   //    Units::FinishVerlet(pool, state, frameTime);
+   inline void FinishVerlet(KinematicState& state, Time dt) { Kinematics::Finish(nullptr, state, dt); }
+   inline void FinishVerlet(ThreadPool& pool, KinematicState& state, Time dt) { Kinematics::Finish(&pool, state, dt); }
+   template <Parallel::ExecutionPolicy Policy>
+   void FinishVerlet(Policy&& policy, KinematicState& state, Time dt)
+   {
+      Kinematics::Finish(Parallel::PoolOf(policy), state, dt);
+   }
+} //end namespace Units
+
+#ifdef UNITS_HEADER_ONLY
+#include "Kinematics.cpp"
+#endif
+
+#endif  // KINEMATICS_H_GUARD
@@ -22,52 +22,39 @@ limitations under the License.
 
 namespace Units
 {
-   class Area;
-   class Time;
-   class Speed;
-
-   class Length
-   {
-   public:
-
-      Area operator*(const Length& length) const;
-      Speed operator/(const Time& time) const;
-      Time operator/(const Speed& time) const;
-
-      GENERIC_OPERATORS(Length);
-   };
+   // Base unit is meters
+   using Length = Quantity<Dimension<1, 0, 0, 0, 0>>;
 
    typedef Length Distance;
-
 } //end namespace Units
 
    // https://www.nist.gov/pml/us-surveyfoot/revised-unit-conversion-factors
-UNIT_TEMPLATE(Length, FlightLevel, 0.032808398950131, fl); //  3.2808398950131E-2 fl/m
-UNIT_TEMPLATE(Length, AstronomicalUnits, 149597870700.0, au); // https://physics.nist.gov/cuu/Units/outside.html 1 au = 149 597 870 700 m, exactly
-UNIT_TEMPLATE(Length, DataMiles, 0.0005468066491689, data_mile); //  5.468066491689E-4 data mile per meter
-UNIT_TEMPLATE(Length, NauticalMiles, 1852.0, nmi); // 1852 m/nmi
-UNIT_TEMPLATE(Length, Miles, (25146000.0 / 15625.0), mi); // https://www.sfei.org/it/gis/map-interpretation/conversion-constants#Constants%20are%20exact // 1609.347 218 694 m
+UNIT_TEMPLATE_RATIO(Length, FlightLevel, 3048, 100, fl); // 100 ft
+UNIT_TEMPLATE_RATIO(Length, AstronomicalUnits, 149597870700, 1, au); // https://physics.nist.gov/cuu/Units/outside.html 1 au = 149 597 870 700 m, exactly
+UNIT_TEMPLATE_RATIO(Length, DataMiles, 18288, 10, data_mile); // 6000 ft
+UNIT_TEMPLATE_RATIO(Length, NauticalMiles, 1852, 1, nmi); // 1852 m/nmi
+UNIT_TEMPLATE_RATIO(Length, Miles, 25146000, 15625, mi); // https://www.sfei.org/it/gis/map-interpretation/conversion-constants#Constants%20are%20exact // 1609.347 218 694 m
 UNIT_TEMPLATE(Length, Leagues, 4828.041656083, league); // 4828.041 656 083 m
 UNIT_TEMPLATE(Length, Fathoms, 1.828803658, fathom); // 1.828 803 658 m
 UNIT_TEMPLATE(Length, Furlong, 201.168402337, furlong); // 201.168 402 337 m
-UNIT_TEMPLATE(Length, Yards, 0.9144, yd); // https://www.sfei.org/it/gis/map-interpretation/conversion-constants#Constants%20are%20exact
-UNIT_TEMPLATE(Length, KiloFeet, 304.8, Kft); // Feet * 1000
-UNIT_TEMPLATE(Length, Feet, 0.3048, ft); // https://www.sfei.org/it/gis/map-interpretation/conversion-constants#Constants%20are%20exact
-UNIT_TEMPLATE(Length, US_Survey_Feet, (1200.0 / 3937.0), survey_ft); // https://www.sfei.org/it/gis/map-interpretation/conversion-constants#Constants%20are%20exact
-UNIT_TEMPLATE(Length, Inches, (0.3048 / 12.0), in);  // Feet/12
+UNIT_TEMPLATE_RATIO(Length, Yards, 9144, 10000, yd); // https://www.sfei.org/it/gis/map-interpretation/conversion-constants#Constants%20are%20exact
+UNIT_TEMPLATE_RATIO(Length, KiloFeet, 3048, 10, Kft); // Feet * 1000
+UNIT_TEMPLATE_RATIO(Length, Feet, 3048, 10000, ft); // https://www.sfei.org/it/gis/map-interpretation/conversion-constants#Constants%20are%20exact
+UNIT_TEMPLATE_RATIO(Length, US_Survey_Feet, 1200, 3937, survey_ft); // https://www.sfei.org/it/gis/map-interpretation/conversion-constants#Constants%20are%20exact
+UNIT_TEMPLATE_RATIO(Length, Inches, 254, 10000, in);  // Feet/12
 
 //Metric
-UNIT_TEMPLATE(Length, Gigameters, (double(std::giga::num) / double(std::giga::den)), Gm);
-UNIT_TEMPLATE(Length, Megameters, (double(std::mega::num) / double(std::mega::den)), Mm);
-UNIT_TEMPLATE(Length, Kilometers, (double(std::kilo::num) / double(std::kilo::den)), km);
-UNIT_TEMPLATE(Length, Hectometers, (double(std::hecto::num) / double(std::hecto::den)), Hm);
-UNIT_TEMPLATE(Length, Decameters, (double(std::deca::num) / double(std::deca::den)), Dm);
-UNIT_TEMPLATE(Length, Meters, 1.0, m);
-UNIT_TEMPLATE(Length, Decimeters, (double(std::deci::num) / double(std::deci::den)), dm);
-UNIT_TEMPLATE(Length, Centimeters, (double(std::centi::num) / double(std::centi::den)), cm);
-UNIT_TEMPLATE(Length, Millimeters, (double(std::milli::num) / double(std::milli::den)), mm);
-UNIT_TEMPLATE(Length, Micrometers, (double(std::micro::num) / double(std::micro::den)), um);
-UNIT_TEMPLATE(Length, Nanometers, (double(std::nano::num) / double(std::nano::den)), nm);
-UNIT_TEMPLATE(Length, Picometers, (double(std::pico::num) / double(std::pico::den)), pm);
+UNIT_TEMPLATE_RATIO(Length, Gigameters, std::giga::num, std::giga::den, Gm);
+UNIT_TEMPLATE_RATIO(Length, Megameters, std::mega::num, std::mega::den, Mm);
+UNIT_TEMPLATE_RATIO(Length, Kilometers, std::kilo::num, std::kilo::den, km);
+UNIT_TEMPLATE_RATIO(Length, Hectometers, std::hecto::num, std::hecto::den, Hm);
+UNIT_TEMPLATE_RATIO(Length, Decameters, std::deca::num, std::deca::den, Dm);
+UNIT_TEMPLATE_RATIO(Length, Meters, 1, 1, m);
+UNIT_TEMPLATE_RATIO(Length, Decimeters, std::deci::num, std::deci::den, dm);
+UNIT_TEMPLATE_RATIO(Length, Centimeters, std::centi::num, std::centi::den, cm);
+UNIT_TEMPLATE_RATIO(Length, Millimeters, std::milli::num, std::milli::den, mm);
+UNIT_TEMPLATE_RATIO(Length, Micrometers, std::micro::num, std::micro::den, um);
+UNIT_TEMPLATE_RATIO(Length, Nanometers, std::nano::num, std::nano::den, nm);
+UNIT_TEMPLATE_RATIO(Length, Picometers, std::pico::num, std::pico::den, pm);
 
 #endif  // LENGTHTYPE_H_GUARD
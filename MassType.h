@@ -21,43 +21,35 @@ limitations under the License.
 
 namespace Units
 {
-   class Force;
-   class Acceleration;
-   class Density;
-   class Volume;
+   // Base unit is kilograms
+   using Mass = Quantity<Dimension<0, 1, 0, 0, 0>>;
 
-   class Mass
-   {
-   public:
-
-      Force operator*(const Acceleration& acceleration) const;
-      Density operator/(const Volume& volume) const;
-
-      GENERIC_OPERATORS(Mass);
-   };
+   // Metric prefixes are relative to the gram, 1/1000 of the base unit
+   template <class Prefix>
+   using GramPrefix = std::ratio_divide<Prefix, std::kilo>;
 } //end namespace Units
 
 //https://www.nist.gov/pml/special-publication-811/nist-guide-si-appendix-b-conversion-factors/nist-guide-si-appendix-b8
-UNIT_TEMPLATE(Mass, Grain, 0.06479891, gr); // 6.479 891	E-05
-UNIT_TEMPLATE(Mass, Pound, 453.59237, lb); // International Pound agreement
-UNIT_TEMPLATE(Mass, Ounce, (453.59237 / 16.0), oz); // 16 oz per pound
-UNIT_TEMPLATE(Mass, Stone, (453.59237 * 14.0), st); // 14 pounds per stone
-UNIT_TEMPLATE(Mass, ShortTon, (453.59237 * 2000.0), ton_us);
-UNIT_TEMPLATE(Mass, LongTon, (453.59237 * 2240.0), ton_uk);
-UNIT_TEMPLATE(Mass, Tonne, 1000000.0, t); // Metric ton
+UNIT_TEMPLATE(Mass, Grain, 0.00006479891, gr); // 6.479 891	E-05
+UNIT_TEMPLATE(Mass, Pound, 0.45359237, lb); // International Pound agreement
+UNIT_TEMPLATE(Mass, Ounce, (0.45359237 / 16.0), oz); // 16 oz per pound
+UNIT_TEMPLATE(Mass, Stone, (0.45359237 * 14.0), st); // 14 pounds per stone
+UNIT_TEMPLATE(Mass, ShortTon, (0.45359237 * 2000.0), ton_us);
+UNIT_TEMPLATE(Mass, LongTon, (0.45359237 * 2240.0), ton_uk);
+UNIT_TEMPLATE(Mass, Tonne, 1000.0, t); // Metric ton
 
 //Metric
-UNIT_TEMPLATE(Mass, Gigagrams, (double(std::giga::num) / double(std::giga::den)), Gg);
-UNIT_TEMPLATE(Mass, Megagrams, (double(std::mega::num) / double(std::mega::den)), Mg);
-UNIT_TEMPLATE(Mass, Kilograms, (double(std::kilo::num) / double(std::kilo::den)), kg);
-UNIT_TEMPLATE(Mass, Hectograms, (double(std::hecto::num) / double(std::hecto::den)), Hg);
-UNIT_TEMPLATE(Mass, Decagrams, (double(std::deca::num) / double(std::deca::den)), Dg);
-UNIT_TEMPLATE(Mass, Grams, 1.0, g);
-UNIT_TEMPLATE(Mass, Decigrams, (double(std::deci::num) / double(std::deci::den)), dg);
-UNIT_TEMPLATE(Mass, Centigrams, (double(std::centi::num) / double(std::centi::den)), cg);
-UNIT_TEMPLATE(Mass, Milligrams, (double(std::milli::num) / double(std::milli::den)), mg);
-UNIT_TEMPLATE(Mass, Micrograms, (double(std::micro::num) / double(std::micro::den)), ug);
-UNIT_TEMPLATE(Mass, Nanograms, (double(std::nano::num) / double(std::nano::den)), ng);
-UNIT_TEMPLATE(Mass, Picograms, (double(std::pico::num) / double(std::pico::den)), pg);
+UNIT_TEMPLATE_RATIO(Mass, Gigagrams, Units::GramPrefix<std::giga>::num, Units::GramPrefix<std::giga>::den, Gg);
+UNIT_TEMPLATE_RATIO(Mass, Megagrams, Units::GramPrefix<std::mega>::num, Units::GramPrefix<std::mega>::den, Mg);
+UNIT_TEMPLATE_RATIO(Mass, Kilograms, Units::GramPrefix<std::kilo>::num, Units::GramPrefix<std::kilo>::den, kg);
+UNIT_TEMPLATE_RATIO(Mass, Hectograms, Units::GramPrefix<std::hecto>::num, Units::GramPrefix<std::hecto>::den, Hg);
+UNIT_TEMPLATE_RATIO(Mass, Decagrams, Units::GramPrefix<std::deca>::num, Units::GramPrefix<std::deca>::den, Dg);
+UNIT_TEMPLATE_RATIO(Mass, Grams, std::milli::num, std::milli::den, g);
+UNIT_TEMPLATE_RATIO(Mass, Decigrams, Units::GramPrefix<std::deci>::num, Units::GramPrefix<std::deci>::den, dg);
+UNIT_TEMPLATE_RATIO(Mass, Centigrams, Units::GramPrefix<std::centi>::num, Units::GramPrefix<std::centi>::den, cg);
+UNIT_TEMPLATE_RATIO(Mass, Milligrams, Units::GramPrefix<std::milli>::num, Units::GramPrefix<std::milli>::den, mg);
+UNIT_TEMPLATE_RATIO(Mass, Micrograms, Units::GramPrefix<std::micro>::num, Units::GramPrefix<std::micro>::den, ug);
+UNIT_TEMPLATE_RATIO(Mass, Nanograms, Units::GramPrefix<std::nano>::num, Units::GramPrefix<std::nano>::den, ng);
+UNIT_TEMPLATE_RATIO(Mass, Picograms, Units::GramPrefix<std::pico>::num, Units::GramPrefix<std::pico>::den, pg);
 
 #endif  // MASSTYPE_H_GUARD
@@ -21,31 +21,26 @@ limitations under the License.
 
 namespace Units
 {
-   class Power
-   {
-   public:
-
-      GENERIC_OPERATORS(Power);
-   };
+   // Base unit is watts, J / s
+   using Power = Quantity<Dimension<2, 1, -3, 0, 0>>;
 } //end namespace Units
 
-UNIT_TEMPLATE(Power, HorsePower, (1.0 / 745.7), hp);
-UNIT_TEMPLATE_EQUATION(Power, decibelWatts, (std::pow(10, (input / 10.0))), (10.0 * std::log10(m_value)), dBW);
-UNIT_TEMPLATE_EQUATION(Power, decibelMilliwatts, (std::pow(10, (input / 10.0)) * (double(std::milli::num) / double(std::milli::den))),
-   (10.0 * std::log10(m_value * (double(std::milli::den) / double(std::milli::num)))), dBm);
+UNIT_TEMPLATE(Power, HorsePower, 745.7, hp); // electrical horsepower
+UNIT_TEMPLATE_DECIBEL(Power, decibelWatts, 1.0, dBW);
+UNIT_TEMPLATE_DECIBEL(Power, decibelMilliwatts, (double(std::milli::num) / double(std::milli::den)), dBm);
 
 //Metric
-UNIT_TEMPLATE(Power, GigaWatts, (double(std::giga::num) / double(std::giga::den)), GW);
-UNIT_TEMPLATE(Power, MegaWatts, (double(std::mega::num) / double(std::mega::den)), MW);
-UNIT_TEMPLATE(Power, KiloWatts, (double(std::kilo::num) / double(std::kilo::den)), kW);
-UNIT_TEMPLATE(Power, HectoWatts, (double(std::hecto::num) / double(std::hecto::den)), HW);
-UNIT_TEMPLATE(Power, DecaWatts, (double(std::deca::num) / double(std::deca::den)), DW);
-UNIT_TEMPLATE(Power, Watts, 1.0, W);
-UNIT_TEMPLATE(Power, DeciWatts, (double(std::deci::num) / double(std::deci::den)), dW);
-UNIT_TEMPLATE(Power, CentiWatts, (double(std::centi::num) / double(std::centi::den)), cW);
-UNIT_TEMPLATE(Power, MilliWatts, (double(std::milli::num) / double(std::milli::den)), mW);
-UNIT_TEMPLATE(Power, MicroWatts, (double(std::micro::num) / double(std::micro::den)), uW);
-UNIT_TEMPLATE(Power, NanoWatts, (double(std::nano::num) / double(std::nano::den)), nW);
-UNIT_TEMPLATE(Power, PicoWatts, (double(std::pico::num) / double(std::pico::den)), pW);
+UNIT_TEMPLATE_RATIO(Power, GigaWatts, std::giga::num, std::giga::den, GW);
+UNIT_TEMPLATE_RATIO(Power, MegaWatts, std::mega::num, std::mega::den, MW);
+UNIT_TEMPLATE_RATIO(Power, KiloWatts, std::kilo::num, std::kilo::den, kW);
+UNIT_TEMPLATE_RATIO(Power, HectoWatts, std::hecto::num, std::hecto::den, HW);
+UNIT_TEMPLATE_RATIO(Power, DecaWatts, std::deca::num, std::deca::den, DW);
+UNIT_TEMPLATE_RATIO(Power, Watts, 1, 1, W);
+UNIT_TEMPLATE_RATIO(Power, DeciWatts, std::deci::num, std::deci::den, dW);
+UNIT_TEMPLATE_RATIO(Power, CentiWatts, std::centi::num, std::centi::den, cW);
+UNIT_TEMPLATE_RATIO(Power, MilliWatts, std::milli::num, std::milli::den, mW);
+UNIT_TEMPLATE_RATIO(Power, MicroWatts, std::micro::num, std::micro::den, uW);
+UNIT_TEMPLATE_RATIO(Power, NanoWatts, std::nano::num, std::nano::den, nW);
+UNIT_TEMPLATE_RATIO(Power, PicoWatts, std::pico::num, std::pico::den, pW);
 
 #endif  // POWERTYPE_H_GUARD
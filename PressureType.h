@@ -17,21 +17,12 @@ limitations under the License.
 */
 
 #include "UnitBase.h"
+#include <ratio>
 
 namespace Units
 {
-   class Area;
-   class Force;
-
-   class Pressure
-   {
-   public:
-
-      Force operator*(const Area& area) const;
-      Area operator/(const Force& force) const;
-
-      GENERIC_OPERATORS(Pressure);
-   };
+   // Base unit is pascals, N / m^2
+   using Pressure = Quantity<Dimension<-1, 1, -2, 0, 0>>;
 } //end namespace Units
 
 UNIT_TEMPLATE(Pressure, Atmospheres, 101325.0, atm); // Standard Atmosphere https://www.nist.gov/pml/special-publication-811/nist-guide-si-appendix-b-conversion-factors/nist-guide-si-appendix-b9#PRESSURE
@@ -42,17 +33,17 @@ UNIT_TEMPLATE(Pressure, Torr, (101325.0 / 760.0), Torr); // https://en.wikipedia
 UNIT_TEMPLATE(Pressure, MillimetersMercury, (133.3223684), mmHg); 
 
 //Metric
-UNIT_TEMPLATE(Pressure, GigaPascals, (double(std::giga::num) / double(std::giga::den)), GPa);
-UNIT_TEMPLATE(Pressure, MegaPascals, (double(std::mega::num) / double(std::mega::den)), MPa);
-UNIT_TEMPLATE(Pressure, KiloPascals, (double(std::kilo::num) / double(std::kilo::den)), kPa);
-UNIT_TEMPLATE(Pressure, HectoPascals, (double(std::hecto::num) / double(std::hecto::den)), HPa);
-UNIT_TEMPLATE(Pressure, DecaPascals, (double(std::deca::num) / double(std::deca::den)), DPa);
-UNIT_TEMPLATE(Pressure, Pascals, 1.0, Pa);
-UNIT_TEMPLATE(Pressure, DeciPascals, (double(std::deci::num) / double(std::deci::den)), dPa);
-UNIT_TEMPLATE(Pressure, CentiPascals, (double(std::centi::num) / double(std::centi::den)), cPa);
-UNIT_TEMPLATE(Pressure, MilliPascals, (double(std::milli::num) / double(std::milli::den)), mPa);
-UNIT_TEMPLATE(Pressure, MicroPascals, (double(std::micro::num) / double(std::micro::den)), uPa);
-UNIT_TEMPLATE(Pressure, NanoPascals, (double(std::nano::num) / double(std::nano::den)), nPa);
-UNIT_TEMPLATE(Pressure, PicoPascals, (double(std::pico::num) / double(std::pico::den)), pPa);
+UNIT_TEMPLATE_RATIO(Pressure, GigaPascals, std::giga::num, std::giga::den, GPa);
+UNIT_TEMPLATE_RATIO(Pressure, MegaPascals, std::mega::num, std::mega::den, MPa);
+UNIT_TEMPLATE_RATIO(Pressure, KiloPascals, std::kilo::num, std::kilo::den, kPa);
+UNIT_TEMPLATE_RATIO(Pressure, HectoPascals, std::hecto::num, std::hecto::den, HPa);
+UNIT_TEMPLATE_RATIO(Pressure, DecaPascals, std::deca::num, std::deca::den, DPa);
+UNIT_TEMPLATE_RATIO(Pressure, Pascals, 1, 1, Pa);
+UNIT_TEMPLATE_RATIO(Pressure, DeciPascals, std::deci::num, std::deci::den, dPa);
+UNIT_TEMPLATE_RATIO(Pressure, CentiPascals, std::centi::num, std::centi::den, cPa);
+UNIT_TEMPLATE_RATIO(Pressure, MilliPascals, std::milli::num, std::milli::den, mPa);
+UNIT_TEMPLATE_RATIO(Pressure, MicroPascals, std::micro::num, std::micro::den, uPa);
+UNIT_TEMPLATE_RATIO(Pressure, NanoPascals, std::nano::num, std::nano::den, nPa);
+UNIT_TEMPLATE_RATIO(Pressure, PicoPascals, std::pico::num, std::pico::den, pPa);
 
 #endif  // PRESSURETYPE_H_GUARD
@@ -0,0 +1,71 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#ifndef QUANTITYARRAY_CPP_GUARD
+#define QUANTITYARRAY_CPP_GUARD
+
+#include "QuantityArray.h"
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace Units
+{
+   namespace ArrayMemoryLayout
+   {
+      constexpr std::size_t CACHE_LINE = 64;
+      constexpr std::size_t HUGE_PAGE = 2 * 1024 * 1024;
+
+      inline std::size_t Alignment(ArrayMemory memory)
+      {
+         return (memory == ArrayMemory::HugePages) ? HUGE_PAGE : CACHE_LINE;
+      }
+   } //end namespace ArrayMemoryLayout
+
+   UNITS_INLINE void* AllocateArray(std::size_t bytes, ArrayMemory memory)
+   {
+      if (bytes == 0)
+      {
+         return nullptr;
+      }
+
+      // Whole aligned blocks, so a huge page is never shared with other data
+      const std::size_t alignment = ArrayMemoryLayout::Alignment(memory);
+      const std::size_t rounded = ((bytes + alignment - 1) / alignment) * alignment;
+      void* data = ::operator new(rounded, std::align_val_t(alignment));
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+      // Only advice, the array still works on normal pages if the kernel says no
+      if (memory == ArrayMemory::HugePages)
+      {
+         madvise(data, rounded, MADV_HUGEPAGE);
+      }
+#endif
+      return data;
+   }
+
+   UNITS_INLINE void FreeArray(void* data, ArrayMemory memory)
+   {
+      if (data != nullptr)
+      {
+         ::operator delete(data, std::align_val_t(ArrayMemoryLayout::Alignment(memory)));
+      }
+   }
+} //end namespace Units
+
+#endif  // QUANTITYARRAY_CPP_GUARD
@@ -0,0 +1,207 @@
+#ifndef QUANTITYARRAY_H_GUARD
+#define QUANTITYARRAY_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include "ArrayExpression.h"
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace Units
+{
+   // Where the storage of a QuantityArray comes from
+   enum class ArrayMemory
+   {
+      Aligned,    // 64 byte aligned, a cache line and an AVX-512 vector
+      HugePages   // 2 MiB aligned and, on Linux, advised onto transparent huge pages
+   };
+
+   // Raw storage for QuantityArray, null for zero bytes
+   UNITS_INLINE void* AllocateArray(std::size_t bytes, ArrayMemory memory);
+   UNITS_INLINE void FreeArray(void* data, ArrayMemory memory);
+
+   // Reads and writes the elements of a QuantityArray as values of Unit,
+   // arr.View<Units::Feet>()[i] is element i in feet
+   template <class Unit, class Element>
+   class UnitView
+   {
+      static_assert(std::is_base_of_v<std::remove_const_t<Element>, Unit>, "view unit must be of the array dimension");
+
+   public:
+      explicit UnitView(std::span<Element> elements) : m_elements(elements) {}
+
+      std::size_t size() const { return m_elements.size(); }
+
+      double operator[](std::size_t index) const { return Unit(m_elements[index]).value(); }
+      void Set(std::size_t index, double value) { m_elements[index] = Unit(value); }
+
+      void CopyTo(std::span<double> output) const
+      {
+         if (output.size() < m_elements.size())
+         {
+            throw std::invalid_argument("Units::UnitView output is smaller than the view");
+         }
+         const std::size_t count = m_elements.size();
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            output[i] = Unit(m_elements[i]).value();
+         }
+      }
+      void CopyFrom(std::span<const double> input)
+      {
+         if (input.size() != m_elements.size())
+         {
+            throw std::invalid_argument("Units::UnitView input is not the size of the view");
+         }
+         const std::size_t count = m_elements.size();
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            m_elements[i] = Unit(input[i]);
+         }
+      }
+
+   private:
+      std::span<Element> m_elements;
+   };
+
+   // Quantities of one dimension stored contiguously as their base unit
+   // doubles in aligned memory, so loops over them vectorize like loops over
+   // a plain double array while every element keeps its type. Element is a
+   // Quantity such as Length, or double for dimensionless results.
+   // Arithmetic between arrays follows the scalar rules element by element,
+   // a Length array divided by a Time array is a Speed array, and is fused
+   // into a single loop by the expression nodes of ArrayExpression.h.
+   template <class Element>
+   class QuantityArray
+   {
+      static_assert(StoredAsDouble<Element> && (sizeof(Element) == sizeof(double)) && std::is_trivially_copyable_v<Element>,
+         "QuantityArray holds quantities stored as doubles, or doubles");
+
+   public:
+      using value_type = Element;
+
+      QuantityArray() = default;
+      explicit QuantityArray(std::size_t size, ArrayMemory memory = ArrayMemory::Aligned)
+         : m_data(static_cast<Element*>(AllocateArray(size * sizeof(Element), memory))), m_size(size), m_memory(memory)
+      {
+         std::memset(static_cast<void*>(m_data), 0, size * sizeof(Element));
+      }
+      QuantityArray(const QuantityArray& rhs) : QuantityArray(rhs.m_size, rhs.m_memory)
+      {
+         std::memcpy(static_cast<void*>(m_data), rhs.m_data, m_size * sizeof(Element));
+      }
+      QuantityArray(QuantityArray&& rhs) noexcept
+         : m_data(std::exchange(rhs.m_data, nullptr)), m_size(std::exchange(rhs.m_size, 0)), m_memory(rhs.m_memory)
+      {
+      }
+      QuantityArray& operator=(const QuantityArray& rhs)
+      {
+         if (this != &rhs)
+         {
+            *this = QuantityArray(rhs);
+         }
+         return *this;
+      }
+      QuantityArray& operator=(QuantityArray&& rhs) noexcept
+      {
+         std::swap(m_data, rhs.m_data);
+         std::swap(m_size, rhs.m_size);
+         std::swap(m_memory, rhs.m_memory);
+         return *this;
+      }
+      ~QuantityArray() { FreeArray(m_data, m_memory); }
+
+      // Evaluates an expression of arrays in one pass
+      template <class Expression>
+         requires ArrayExpressionOf<Expression, Element>
+      QuantityArray(const Expression& expression, ArrayMemory memory = ArrayMemory::Aligned) : QuantityArray(expression.size(), memory)
+      {
+         Assign(expression);
+      }
+      // The expression may read this array, every element is read before it
+      // is written
+      template <class Expression>
+         requires ArrayExpressionOf<Expression, Element>
+      QuantityArray& operator=(const Expression& expression)
+      {
+         if (expression.size() != m_size)
+         {
+            *this = QuantityArray(expression.size(), m_memory);
+         }
+         Assign(expression);
+         return *this;
+      }
+
+      std::size_t size() const { return m_size; }
+      bool empty() const { return m_size == 0; }
+      ArrayMemory Memory() const { return m_memory; }
+
+      Element& operator[](std::size_t index) { return m_data[index]; }
+      const Element& operator[](std::size_t index) const { return m_data[index]; }
+
+      Element* begin() { return m_data; }
+      Element* end() { return m_data + m_size; }
+      const Element* begin() const { return m_data; }
+      const Element* end() const { return m_data + m_size; }
+
+      std::span<Element> Elements() { return std::span<Element>(m_data, m_size); }
+      std::span<const Element> Elements() const { return std::span<const Element>(m_data, m_size); }
+
+      // The base unit doubles, valid since every unit type is laid out as a
+      // single double (UNIT_LAYOUT_CHECKS)
+      std::span<double> Values() { return std::span<double>(reinterpret_cast<double*>(m_data), m_size); }
+      std::span<const double> Values() const { return std::span<const double>(reinterpret_cast<const double*>(m_data), m_size); }
+
+      template <class Unit>
+      UnitView<Unit, Element> View() { return UnitView<Unit, Element>(Elements()); }
+      template <class Unit>
+      UnitView<Unit, const Element> View() const { return UnitView<Unit, const Element>(Elements()); }
+
+      template <class Rhs>
+      QuantityArray& operator+=(const Rhs& rhs) { return *this = (*this + rhs); }
+      template <class Rhs>
+      QuantityArray& operator-=(const Rhs& rhs) { return *this = (*this - rhs); }
+      QuantityArray& operator*=(double rhs) { return *this = (*this * rhs); }
+      QuantityArray& operator/=(double rhs) { return *this = (*this / rhs); }
+
+   private:
+      template <class Expression>
+      void Assign(const Expression& expression)
+      {
+         const auto operand = ArrayExpressions::OperandOf<Expression>::Make(expression);
+         double* values = Values().data();
+         for (std::size_t i = 0; i < m_size; ++i)
+         {
+            values[i] = operand.Evaluate(i);
+         }
+      }
+
+      Element* m_data = nullptr;
+      std::size_t m_size = 0;
+      ArrayMemory m_memory = ArrayMemory::Aligned;
+   };
+} //end namespace Units
+
+#ifdef UNITS_HEADER_ONLY
+#include "QuantityArray.cpp"
+#endif
+
+#endif  // QUANTITYARRAY_H_GUARD
@@ -0,0 +1,397 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#ifndef QUANTITYFILE_CPP_GUARD
+#define QUANTITYFILE_CPP_GUARD
+
+#include "QuantityFile.h"
+#include "QuantityArray.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define UNITS_MAP_FILES
+#endif
+
+namespace Units
+{
+   namespace QuantityFileLayout
+   {
+      inline Header MakeHeader()
+      {
+         Header header{};
+         header.magic = MAGIC;
+         header.version = VERSION;
+         header.byteOrder = BYTE_ORDER_MARK;
+         return header;
+      }
+
+      // Nul padded fixed length text up to its first nul
+      template <std::size_t Length>
+      inline std::string_view FixedText(const std::array<char, Length>& text)
+      {
+         return std::string_view(text.data(), std::size_t(std::find(text.begin(), text.end(), '\0') - text.begin()));
+      }
+
+      // Unit of a dimension the base values are in, every registered
+      // dimension has one
+      inline UnitId BaseUnitOf(DimensionId dimension)
+      {
+         for (std::size_t unit = 0; unit < Registry::UNIT_COUNT; ++unit)
+         {
+            const UnitRecord& record = GetUnitRecord(UnitId(unit));
+            if ((record.dimension == dimension) && record.affine && (record.scale == 1.0) && (record.offset == 0.0))
+            {
+               return UnitId(unit);
+            }
+         }
+         return UnitId::Invalid;
+      }
+   } //end namespace QuantityFileLayout
+
+   UNITS_INLINE QuantityFileWriter::QuantityFileWriter(const std::string& path)
+      : m_file(std::fopen(path.c_str(), "wb"))
+   {
+      if (m_file == nullptr)
+      {
+         throw std::runtime_error("Units::QuantityFileWriter cannot create " + path);
+      }
+      const QuantityFileLayout::Header header = QuantityFileLayout::MakeHeader();
+      Write(&header, sizeof(header));
+   }
+
+   UNITS_INLINE QuantityFileWriter::~QuantityFileWriter()
+   {
+      try
+      {
+         Close();
+      }
+      catch (...)
+      {
+      }
+   }
+
+   UNITS_INLINE std::size_t QuantityFileWriter::AddColumn(std::string_view name, UnitId unit)
+   {
+      if (m_file == nullptr)
+      {
+         throw std::invalid_argument("Units::QuantityFileWriter is closed");
+      }
+      if (!m_blocks.empty())
+      {
+         throw std::invalid_argument("Units::QuantityFileWriter columns must be added before the first block");
+      }
+      if (!IsValid(unit))
+      {
+         throw std::invalid_argument("Units::QuantityFileWriter invalid unit");
+      }
+      if (name.empty() || (name.size() > QuantityFileLayout::NAME_LENGTH) || (name.find('\0') != std::string_view::npos))
+      {
+         throw std::invalid_argument("Units::QuantityFileWriter column names are 1 to 32 characters");
+      }
+
+      const UnitRecord& record = GetUnitRecord(unit);
+      const Registry::DimensionKey& key = Registry::DIMENSIONS.keys[record.dimension];
+      QuantityFileLayout::ColumnEntry entry{};
+      std::copy(name.begin(), name.end(), entry.name.begin());
+      std::copy(record.suffix.begin(), record.suffix.end(), entry.suffix.begin());
+      for (std::size_t i = 0; i < key.size(); ++i)
+      {
+         entry.exponents[i] = std::int8_t(key[i]);
+      }
+      m_columns.push_back(entry);
+      return m_columns.size() - 1;
+   }
+
+   UNITS_INLINE void QuantityFileWriter::CheckDimensions(std::span<const Registry::DimensionKey> keys) const
+   {
+      for (std::size_t column = 0; (column < keys.size()) && (column < m_columns.size()); ++column)
+      {
+         for (std::size_t i = 0; i < keys[column].size(); ++i)
+         {
+            if (keys[column][i] != m_columns[column].exponents[i])
+            {
+               throw std::invalid_argument("Units::QuantityFileWriter column is of another dimension");
+            }
+         }
+      }
+   }
+
+   UNITS_INLINE void QuantityFileWriter::AppendBlock(std::span<const std::span<const double>> columns)
+   {
+      if (m_file == nullptr)
+      {
+         throw std::invalid_argument("Units::QuantityFileWriter is closed");
+      }
+      if (m_columns.empty() || (columns.size() != m_columns.size()))
+      {
+         throw std::invalid_argument("Units::QuantityFileWriter a block needs one span per column");
+      }
+      const std::size_t rows = columns[0].size();
+      for (const std::span<const double>& column : columns)
+      {
+         if (column.size() != rows)
+         {
+            throw std::invalid_argument("Units::QuantityFileWriter columns of a block differ in size");
+         }
+      }
+      if (rows == 0)
+      {
+         return;
+      }
+
+      static constexpr std::array<std::byte, QuantityFileLayout::ALIGNMENT> PADDING{};
+      const std::size_t bytes = rows * sizeof(double);
+      const std::size_t padded = QuantityFileLayout::PaddedBytes(rows);
+      const QuantityFileLayout::BlockEntry block{ m_offset, rows };
+      for (const std::span<const double>& column : columns)
+      {
+         Write(column.data(), bytes);
+         Write(PADDING.data(), padded - bytes);
+      }
+      m_blocks.push_back(block);
+      m_rows += rows;
+   }
+
+   UNITS_INLINE void QuantityFileWriter::Close()
+   {
+      if (m_file == nullptr)
+      {
+         return;
+      }
+
+      QuantityFileLayout::Header footer = QuantityFileLayout::MakeHeader();
+      footer.columns = m_columns.size();
+      footer.blocks = m_blocks.size();
+      footer.rows = m_rows;
+      footer.directory = m_offset;
+      try
+      {
+         Write(m_columns.data(), m_columns.size() * sizeof(QuantityFileLayout::ColumnEntry));
+         Write(m_blocks.data(), m_blocks.size() * sizeof(QuantityFileLayout::BlockEntry));
+         Write(&footer, sizeof(footer));
+      }
+      catch (...)
+      {
+         std::fclose(m_file);
+         m_file = nullptr;
+         throw;
+      }
+
+      const bool closed = (std::fclose(m_file) == 0);
+      m_file = nullptr;
+      if (!closed)
+      {
+         throw std::runtime_error("Units::QuantityFileWriter close failed");
+      }
+   }
+
+   UNITS_INLINE void QuantityFileWriter::Write(const void* data, std::size_t bytes)
+   {
+      if ((bytes > 0) && (std::fwrite(data, 1, bytes, m_file) != bytes))
+      {
+         throw std::runtime_error("Units::QuantityFileWriter write failed");
+      }
+      m_offset += bytes;
+   }
+
+   UNITS_INLINE QuantityFileReader::QuantityFileReader(const std::string& path)
+   {
+#ifdef UNITS_MAP_FILES
+      const int descriptor = ::open(path.c_str(), O_RDONLY);
+      if (descriptor < 0)
+      {
+         throw std::runtime_error("Units::QuantityFileReader cannot open " + path);
+      }
+      struct stat status;
+      const bool sized = (::fstat(descriptor, &status) == 0);
+      m_size = sized ? std::size_t(status.st_size) : 0;
+      void* const data = (m_size > 0) ? ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+      ::close(descriptor);
+      if (data == MAP_FAILED)
+      {
+         throw std::runtime_error("Units::QuantityFileReader cannot map " + path);
+      }
+      m_data = static_cast<const std::byte*>(data);
+#else
+      // Without mmap the whole file is read into aligned memory
+      std::FILE* const file = std::fopen(path.c_str(), "rb");
+      if (file == nullptr)
+      {
+         throw std::runtime_error("Units::QuantityFileReader cannot open " + path);
+      }
+      std::fseek(file, 0, SEEK_END);
+      const long size = std::ftell(file);
+      std::fseek(file, 0, SEEK_SET);
+      m_size = (size > 0) ? std::size_t(size) : 0;
+      void* const data = AllocateArray(m_size, ArrayMemory::Aligned);
+      const bool read = (m_size > 0) && (std::fread(data, 1, m_size, file) == m_size);
+      std::fclose(file);
+      m_data = static_cast<const std::byte*>(data);
+      if (!read)
+      {
+         FreeArray(data, ArrayMemory::Aligned);
+         throw std::runtime_error("Units::QuantityFileReader cannot read " + path);
+      }
+#endif
+
+      try
+      {
+         using namespace QuantityFileLayout;
+         Header header;
+         Header footer;
+         if (m_size < (2 * sizeof(Header)))
+         {
+            throw std::runtime_error("Units::QuantityFileReader " + path + " is not a quantity file");
+         }
+         std::memcpy(&header, m_data, sizeof(header));
+         std::memcpy(&footer, m_data + (m_size - sizeof(footer)), sizeof(footer));
+         if ((header.magic != MAGIC) || (footer.magic != MAGIC))
+         {
+            throw std::runtime_error("Units::QuantityFileReader " + path + " is not a complete quantity file");
+         }
+         if ((footer.byteOrder != BYTE_ORDER_MARK) || (footer.version != VERSION))
+         {
+            throw std::runtime_error("Units::QuantityFileReader " + path + " has another version or byte order");
+         }
+
+         // The directory must fill the space between the data and the footer
+         const std::uint64_t directoryBytes = (footer.columns * sizeof(ColumnEntry)) + (footer.blocks * sizeof(BlockEntry));
+         if ((footer.columns > m_size) || (footer.blocks > m_size) ||
+            ((footer.directory + directoryBytes + sizeof(footer)) != m_size) || ((footer.directory % ALIGNMENT) != 0))
+         {
+            throw std::runtime_error("Units::QuantityFileReader " + path + " has a damaged directory");
+         }
+
+         const std::byte* entry = m_data + footer.directory;
+         m_columns.reserve(std::size_t(footer.columns));
+         for (std::uint64_t i = 0; i < footer.columns; ++i, entry += sizeof(ColumnEntry))
+         {
+            ColumnEntry column;
+            std::memcpy(&column, entry, sizeof(column));
+            QuantityColumn& added = m_columns.emplace_back();
+            // Names point into the mapping
+            added.name = FixedText(reinterpret_cast<const ColumnEntry*>(entry)->name);
+            added.suffix = FixedText(reinterpret_cast<const ColumnEntry*>(entry)->suffix);
+            for (std::size_t e = 0; e < added.exponents.size(); ++e)
+            {
+               added.exponents[e] = column.exponents[e];
+            }
+            added.dimension = Registry::FindDimension(added.exponents);
+            added.unit = FindUnit(added.suffix);
+            if ((added.unit != UnitId::Invalid) && (GetUnitRecord(added.unit).dimension != added.dimension))
+            {
+               added.unit = UnitId::Invalid;
+            }
+         }
+
+         m_blocks.resize(std::size_t(footer.blocks));
+         std::memcpy(m_blocks.data(), entry, m_blocks.size() * sizeof(BlockEntry));
+         std::uint64_t end = sizeof(Header);
+         for (const BlockEntry& block : m_blocks)
+         {
+            if ((block.offset != end) || (block.rows > m_size) || ((footer.directory - end) < (footer.columns * PaddedBytes(std::size_t(block.rows)))))
+            {
+               throw std::runtime_error("Units::QuantityFileReader " + path + " has a damaged block");
+            }
+            end += footer.columns * PaddedBytes(std::size_t(block.rows));
+            m_rows += std::size_t(block.rows);
+         }
+         if ((end != footer.directory) || (m_rows != footer.rows))
+         {
+            throw std::runtime_error("Units::QuantityFileReader " + path + " has a damaged block");
+         }
+      }
+      catch (...)
+      {
+         Release();
+         throw;
+      }
+   }
+
+   UNITS_INLINE QuantityFileReader::~QuantityFileReader()
+   {
+      Release();
+   }
+
+   UNITS_INLINE void QuantityFileReader::Release()
+   {
+      if (m_data == nullptr)
+      {
+         return;
+      }
+#ifdef UNITS_MAP_FILES
+      ::munmap(const_cast<std::byte*>(m_data), m_size);
+#else
+      FreeArray(const_cast<std::byte*>(m_data), ArrayMemory::Aligned);
+#endif
+      m_data = nullptr;
+   }
+
+   UNITS_INLINE std::size_t QuantityFileReader::FindColumn(std::string_view name) const
+   {
+      for (std::size_t column = 0; column < m_columns.size(); ++column)
+      {
+         if (m_columns[column].name == name)
+         {
+            return column;
+         }
+      }
+      return NOT_FOUND;
+   }
+
+   UNITS_INLINE std::span<const double> QuantityFileReader::BaseValues(std::size_t column, std::size_t block) const
+   {
+      if (column >= m_columns.size())
+      {
+         throw std::out_of_range("Units::QuantityFileReader column out of range");
+      }
+      const QuantityFileLayout::BlockEntry& entry = m_blocks.at(block);
+      const std::size_t rows = std::size_t(entry.rows);
+      const std::byte* const first = m_data + entry.offset + (column * QuantityFileLayout::PaddedBytes(rows));
+      // Aligned to 64 bytes in the file, mappings are page aligned
+      return std::span<const double>(reinterpret_cast<const double*>(first), rows);
+   }
+
+   UNITS_INLINE void QuantityFileReader::Read(std::size_t column, std::span<double> output, UnitId unit) const
+   {
+      if (output.size() < m_rows)
+      {
+         throw std::invalid_argument("Units::QuantityFileReader output is smaller than the column");
+      }
+      const UnitId base = QuantityFileLayout::BaseUnitOf(Column(column).dimension);
+      if (base == UnitId::Invalid)
+      {
+         throw std::invalid_argument("Units::QuantityFileReader column dimension is not registered");
+      }
+
+      std::size_t row = 0;
+      for (std::size_t block = 0; block < m_blocks.size(); ++block)
+      {
+         const std::span<const double> values = BaseValues(column, block);
+         convert(values, output.subspan(row, values.size()), base, unit);
+         row += values.size();
+      }
+   }
+} //end namespace Units
+
+#undef UNITS_MAP_FILES
+
+#endif  // QUANTITYFILE_CPP_GUARD
@@ -0,0 +1,223 @@
+#ifndef QUANTITYFILE_H_GUARD
+#define QUANTITYFILE_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include "UnitRegistry.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Units
+{
+   // A quantity file holds named columns of base unit values, each tagged with
+   // its dimension and the unit it was recorded in. Rows are appended in
+   // blocks, and within a block every column is contiguous and 64 byte
+   // aligned, so a mapped file is read as quantity spans without copies.
+   //
+   //    header    64 bytes, magic and version
+   //    block 0   column 0 values, padded to 64 bytes, column 1 values, ...
+   //    block 1   ...
+   //    columns   one ColumnEntry per column
+   //    blocks    one BlockEntry per block
+   //    footer    64 bytes, the header with the counts and directory offset
+   //
+   // Integers and doubles are in the writer's byte order, which the reader checks.
+   namespace QuantityFileLayout
+   {
+      inline constexpr std::size_t ALIGNMENT = 64;
+      // 2 stores temperatures in kelvin, the base unit, 1 stored them in Celsius
+      inline constexpr std::uint32_t VERSION = 2;
+      inline constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+      inline constexpr std::array<char, 8> MAGIC{ 'U', 'N', 'I', 'T', 'S', 'Q', 'T', 'Y' };
+      inline constexpr std::size_t NAME_LENGTH = 32;
+      inline constexpr std::size_t SUFFIX_LENGTH = 24;
+
+      struct Header
+      {
+         std::array<char, 8> magic;
+         std::uint32_t version;
+         std::uint32_t byteOrder;
+         std::uint64_t columns;
+         std::uint64_t blocks;
+         std::uint64_t rows;
+         std::uint64_t directory;      // offset of the column entries, 0 in the leading header
+         std::array<std::uint8_t, 16> reserved;
+      };
+
+      // Names and suffixes are nul padded
+      struct ColumnEntry
+      {
+         std::array<char, NAME_LENGTH> name;
+         std::array<char, SUFFIX_LENGTH> suffix;
+         std::array<std::int8_t, 5> exponents;   // length, mass, time, temperature, angle
+         std::array<std::uint8_t, 3> reserved;
+      };
+
+      // Column c of a block starts at offset + (c * PaddedBytes(rows))
+      struct BlockEntry
+      {
+         std::uint64_t offset;
+         std::uint64_t rows;
+      };
+
+      static_assert(sizeof(Header) == ALIGNMENT, "header fills one aligned block");
+      static_assert(sizeof(ColumnEntry) == ALIGNMENT, "column entries are 64 bytes");
+      static_assert(sizeof(BlockEntry) == 16, "block entries are 16 bytes");
+
+      constexpr std::size_t PaddedBytes(std::size_t rows)
+      {
+         return (((rows * sizeof(double)) + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT;
+      }
+   } //end namespace QuantityFileLayout
+
+   // Streams a quantity file, append only. Columns are declared first, then
+   // every AppendBlock call adds rows to all of them. Larger blocks give
+   // longer contiguous spans to the reader. Errors throw std::runtime_error
+   // (I/O) or std::invalid_argument (misuse).
+   class QuantityFileWriter
+   {
+   public:
+      UNITS_INLINE explicit QuantityFileWriter(const std::string& path);
+      // Closes the file, errors are lost, call Close to see them
+      UNITS_INLINE ~QuantityFileWriter();
+
+      QuantityFileWriter(const QuantityFileWriter&) = delete;
+      QuantityFileWriter& operator=(const QuantityFileWriter&) = delete;
+
+      // Column index, tagged with unit and its dimension. Only before the first block.
+      UNITS_INLINE std::size_t AddColumn(std::string_view name, UnitId unit);
+      template <class Unit>
+      std::size_t AddColumn(std::string_view name) { return AddColumn(name, UnitIdOf<Unit>); }
+
+      // One span of base unit values per column, all of one size
+      UNITS_INLINE void AppendBlock(std::span<const std::span<const double>> columns);
+
+      // writer.Append(altitudes, speeds); with one contiguous range of
+      // quantities per column, checked against the column dimensions
+      template <class... Columns>
+      void Append(const Columns&... columns)
+      {
+         const std::array<std::span<const double>, sizeof...(Columns)> values{ BaseValuesOf(columns)... };
+         const std::array<Registry::DimensionKey, sizeof...(Columns)> keys{ Registry::KeyOf<std::ranges::range_value_t<Columns>>()... };
+         CheckDimensions(keys);
+         AppendBlock(values);
+      }
+
+      // Writes the directory and footer, the file is readable after this
+      UNITS_INLINE void Close();
+
+   private:
+      template <class Column>
+      static std::span<const double> BaseValuesOf(const Column& column)
+      {
+         static_assert(StoredAsDouble<std::ranges::range_value_t<Column>> && (sizeof(std::ranges::range_value_t<Column>) == sizeof(double)),
+            "quantities are laid out as a double");
+         return std::span<const double>(reinterpret_cast<const double*>(std::ranges::data(column)), std::ranges::size(column));
+      }
+
+      UNITS_INLINE void CheckDimensions(std::span<const Registry::DimensionKey> keys) const;
+      UNITS_INLINE void Write(const void* data, std::size_t bytes);
+
+      std::FILE* m_file = nullptr;
+      std::vector<QuantityFileLayout::ColumnEntry> m_columns;
+      std::vector<QuantityFileLayout::BlockEntry> m_blocks;
+      std::uint64_t m_offset = 0;
+      std::uint64_t m_rows = 0;
+   };
+
+   // A column as the reader found it. unit is UnitId::Invalid and dimension
+   // INVALID_DIMENSION when this build does not know them, the values are
+   // still readable in the base unit.
+   struct QuantityColumn
+   {
+      std::string_view name;
+      std::string_view suffix;
+      Registry::DimensionKey exponents;
+      UnitId unit;
+      DimensionId dimension;
+   };
+
+   // Memory maps a quantity file, only the footer and directory are read on
+   // open and the pages of a column are touched when it is used. Malformed
+   // files throw std::runtime_error.
+   class QuantityFileReader
+   {
+   public:
+      static constexpr std::size_t NOT_FOUND = std::size_t(-1);
+
+      UNITS_INLINE explicit QuantityFileReader(const std::string& path);
+      UNITS_INLINE ~QuantityFileReader();
+
+      QuantityFileReader(const QuantityFileReader&) = delete;
+      QuantityFileReader& operator=(const QuantityFileReader&) = delete;
+
+      std::size_t Columns() const { return m_columns.size(); }
+      std::size_t Blocks() const { return m_blocks.size(); }
+      std::size_t Rows() const { return m_rows; }
+      std::size_t BlockRows(std::size_t block) const { return std::size_t(m_blocks.at(block).rows); }
+
+      const QuantityColumn& Column(std::size_t column) const { return m_columns.at(column); }
+      UNITS_INLINE std::size_t FindColumn(std::string_view name) const;
+
+      // Base unit values of a column in one block, pointing into the mapping
+      UNITS_INLINE std::span<const double> BaseValues(std::size_t column, std::size_t block) const;
+
+      // Zero copy view as any unit type or quantity of the column's dimension
+      template <class QuantityType>
+      std::span<const QuantityType> View(std::size_t column, std::size_t block) const
+      {
+         static_assert(StoredAsDouble<QuantityType> && (sizeof(QuantityType) == sizeof(double)), "quantities are laid out as a double");
+         if (Column(column).exponents != Registry::KeyOf<QuantityType>())
+         {
+            throw std::invalid_argument("Units::QuantityFileReader column is of another dimension");
+         }
+         const std::span<const double> values = BaseValues(column, block);
+         return std::span<const QuantityType>(reinterpret_cast<const QuantityType*>(values.data()), values.size());
+      }
+
+      // Every row of a column converted to unit on the batch kernels,
+      // output must hold Rows() values
+      UNITS_INLINE void Read(std::size_t column, std::span<double> output, UnitId unit) const;
+      // In the unit the column was recorded in
+      void Read(std::size_t column, std::span<double> output) const { Read(column, output, Column(column).unit); }
+      template <class Unit>
+      void Read(std::size_t column, std::span<double> output) const { Read(column, output, UnitIdOf<Unit>); }
+
+   private:
+      UNITS_INLINE void Release();
+
+      const std::byte* m_data = nullptr;
+      std::size_t m_size = 0;
+      std::vector<QuantityColumn> m_columns;
+      std::vector<QuantityFileLayout::BlockEntry> m_blocks;
+      std::size_t m_rows = 0;
+   };
+} //end namespace Units
+
+#ifdef UNITS_HEADER_ONLY
+#include "QuantityFile.cpp"
+#endif
+
+#endif  // QUANTITYFILE_H_GUARD
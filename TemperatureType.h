@@ -21,39 +21,30 @@ limitations under the License.
 
 namespace Units
 {
-   class Temperature
-   {
-   public:
-
-      GENERIC_OPERATORS(Temperature);
-   };
-
+   // Base unit is kelvin, the SI unit, so products and quotients with other
+   // quantities (J/K, W/(m^2 K^4)) are in coherent units. The other scales
+   // are affine, a temperature difference has to be taken in kelvin.
+   using Temperature = Quantity<Dimension<0, 0, 0, 1, 0>>;
 } //end namespace Units
 
 // from: https://www.weather.gov/media/epz/wxcalc/tempConvert.pdf
-//To convert between degrees Celsius(°C) --> Kelvin(K) || Rankine (R) || Farenheit (F):
+//To convert between Kelvin(K) --> degrees Celsius(°C) || Rankine (R) || Farenheit (F):
 // Updated with International Bureau of Weights and Measures
 //    2019 redefinition of the SI base units
 //    see: https://en.wikipedia.org/wiki/2019_redefinition_of_the_SI_base_units
 //
-//    Tc = Tk - 273.15
 //    Tk = Tc + 273.15
-//
-//    Tc = (5 / 9) * (Tf - 32)
-//    Tf = ((9 / 5) * Tc) + 32
-//
-//    Tc = (5 / 9) * ((Tr - 459.67) - 32)
-//    Tr = ((9 / 5) * Tc) + 32) + 459.67
+//    Tk = (5 / 9) * (Tf + 459.67)
+//    Tk = (5 / 9) * Tr
 //
 //    Where Tc is temperature in Celsius
 //          Tk is temperature in Kelvin
 //          Tr is temperature in Rankine
 //          Tf is temperature in Fareneheit
 //
-UNIT_TEMPLATE(Temperature, Celsius, 1.0, degC); // Base Unit
-UNIT_TEMPLATE_EQUATION(Temperature, Kelvin, (input - 273.15), (m_value + 273.15) , degK); //  https://www.bipm.org/documents/20126/41483022/SI-Brochure-9.pdf pg.133
-UNIT_TEMPLATE_EQUATION(Temperature, Farenheit, ((5.0 / 9.0) * (input - 32.0)), ((9.0/5.0 * m_value) + 32), degF); // 
-UNIT_TEMPLATE_EQUATION(Temperature, Rankine, ((5.0/9.0) * ((input - 459.67) - 32.0)), ((((9.0/5.0) * m_value) + 32.0) + 459.67), degR); // https://nvlpubs.nist.gov/nistpubs/Legacy/SP/nistspecialpublication811e2008.pdf pg.66
-
+UNIT_TEMPLATE(Temperature, Kelvin, 1.0, degK); // Base Unit, https://www.bipm.org/documents/20126/41483022/SI-Brochure-9.pdf pg.133
+UNIT_TEMPLATE_AFFINE(Temperature, Celsius, 1.0, 273.15, degC);
+UNIT_TEMPLATE_AFFINE(Temperature, Farenheit, (5.0 / 9.0), ((5.0 / 9.0) * 459.67), degF);
+UNIT_TEMPLATE_RATIO(Temperature, Rankine, 5, 9, degR); // https://nvlpubs.nist.gov/nistpubs/Legacy/SP/nistspecialpublication811e2008.pdf pg.66
 
 #endif  // TEMPERATURETYPE_H_GUARD
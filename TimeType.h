@@ -22,34 +22,24 @@ limitations under the License.
 
 namespace Units
 {
-   class Length;
-   class Speed;
-
-   class Time
-   {
-   public:
-
-      Length operator*(const Speed& speed) const;
-
-      GENERIC_OPERATORS(Time);
-   };
-
+   // Base unit is seconds
+   using Time = Quantity<Dimension<0, 0, 1, 0, 0>>;
 } //end namespace Units
 
    // Leap seconds are not taken into account
-UNIT_TEMPLATE(Time, LeapYears, 31622400.0, leap_yr); // Based on 366 days per year
-UNIT_TEMPLATE(Time, NonLeapYears, 31536000, non_leap_yr); // Based on 365 days per year
-UNIT_TEMPLATE(Time, Years, 31557600, yr); // Based on 365.25 days per year
-UNIT_TEMPLATE(Time, NonLeapYearMonths, 2628000, non_leap_yr_mon); // Based on 12 months per non leap year
-UNIT_TEMPLATE(Time, Months, 2629800, mon); // Based on 12 months per year
-UNIT_TEMPLATE(Time, Weeks, 604800, wk);
-UNIT_TEMPLATE(Time, Days, 86400, day);
-UNIT_TEMPLATE(Time, Hours, 3600, hr);
-UNIT_TEMPLATE(Time, Minutes, 60, min);
-UNIT_TEMPLATE(Time, Seconds, 1, s);
-UNIT_TEMPLATE(Time, Milliseconds, (double(std::milli::num) / double(std::milli::den)), ms);
-UNIT_TEMPLATE(Time, Microseconds, (double(std::micro::num) / double(std::micro::den)), us);
-UNIT_TEMPLATE(Time, Nanoseconds, (double(std::nano::num) / double(std::nano::den)), ns);
-UNIT_TEMPLATE(Time, Picoseconds, (double(std::pico::num) / double(std::pico::den)), ps);
+UNIT_TEMPLATE_RATIO(Time, LeapYears, 31622400, 1, leap_yr); // Based on 366 days per year
+UNIT_TEMPLATE_RATIO(Time, NonLeapYears, 31536000, 1, non_leap_yr); // Based on 365 days per year
+UNIT_TEMPLATE_RATIO(Time, Years, 31557600, 1, yr); // Based on 365.25 days per year
+UNIT_TEMPLATE_RATIO(Time, NonLeapYearMonths, 2628000, 1, non_leap_yr_mon); // Based on 12 months per non leap year
+UNIT_TEMPLATE_RATIO(Time, Months, 2629800, 1, mon); // Based on 12 months per year
+UNIT_TEMPLATE_RATIO(Time, Weeks, 604800, 1, wk);
+UNIT_TEMPLATE_RATIO(Time, Days, 86400, 1, day);
+UNIT_TEMPLATE_RATIO(Time, Hours, 3600, 1, hr);
+UNIT_TEMPLATE_RATIO(Time, Minutes, 60, 1, min);
+UNIT_TEMPLATE_RATIO(Time, Seconds, 1, 1, s);
+UNIT_TEMPLATE_RATIO(Time, Milliseconds, std::milli::num, std::milli::den, ms);
+UNIT_TEMPLATE_RATIO(Time, Microseconds, std::micro::num, std::micro::den, us);
+UNIT_TEMPLATE_RATIO(Time, Nanoseconds, std::nano::num, std::nano::den, ns);
+UNIT_TEMPLATE_RATIO(Time, Picoseconds, std::pico::num, std::pico::den, ps);
 
 #endif  // TIMETYPE_H_GUARD
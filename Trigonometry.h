@@ -0,0 +1,262 @@
+#ifndef TRIGONOMETRY_H_GUARD
+#define TRIGONOMETRY_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(__GNUC__)
+#define UNITS_TRIG_INLINE [[gnu::always_inline]] constexpr
+#else
+#define UNITS_TRIG_INLINE constexpr
+#endif
+
+namespace Units
+{
+   // Sine, cosine and arctangent written once over "lanes", either a plain
+   // double or a GCC / Clang vector of doubles, so the scalar functions and
+   // every batch kernel share the same arithmetic. Vectors are only passed by
+   // reference, see UnitBatch.cpp. Range reduction is exact: binary angles
+   // split into quadrants with integer operations, and degrees by subtracting
+   // a whole number of 90 degree steps. The reduced angle is within
+   // [-pi / 4, pi / 4] radians, where sine and cosine are their Taylor
+   // series to degree 15 and 16 (truncation below 1e-16).
+   // Not valid under -ffast-math, which folds the rounding adds away.
+   namespace Trigonometry
+   {
+      inline constexpr double PI = 3.141592653589793238462643383279502884;
+      inline constexpr double HALF_PI = PI / 2.0;
+      inline constexpr double QUARTER_PI = PI / 4.0;
+      // Adding then subtracting 1.5 * 2^52 rounds any |x| < 2^51 to the nearest
+      // whole number
+      inline constexpr double ROUNDING_BIAS = 6755399441055744.0;
+      inline constexpr double TWO_POW_51 = 2251799813685248.0;
+
+      // Element lanes matching the lanes of Doubles
+      template <class Element, class Doubles>
+      struct LanesOf;
+      template <class Element>
+      struct LanesOf<Element, double>
+      {
+         using type = Element;
+      };
+
+#if defined(__GNUC__)
+      template <class Element, std::size_t Count>
+      struct VectorOf
+      {
+         typedef Element type __attribute__((vector_size(Count * sizeof(Element))));
+      };
+      template <class Element, class Doubles>
+      struct LanesOf
+      {
+         using type = typename VectorOf<Element, sizeof(Doubles) / sizeof(double)>::type;
+      };
+#endif
+
+      // Lane by lane conversion, as static_cast does for a single lane
+      template <class To, class From>
+      UNITS_TRIG_INLINE void ConvertLanes(const From& from, To& to)
+      {
+         if constexpr (std::is_arithmetic_v<From>)
+         {
+            to = To(from);
+         }
+         else
+         {
+#if defined(__GNUC__)
+            to = __builtin_convertvector(from, To);
+#endif
+         }
+      }
+
+      // sin(x) and cos(x) for |x| <= pi / 4
+      template <class Doubles>
+      UNITS_TRIG_INLINE void SinCosReduced(const Doubles& x, Doubles& sine, Doubles& cosine)
+      {
+         const Doubles x2 = x * x;
+
+         Doubles series = Doubles{} - (1.0 / 1307674368000.0);
+         series = (series * x2) + (1.0 / 6227020800.0);
+         series = (series * x2) - (1.0 / 39916800.0);
+         series = (series * x2) + (1.0 / 362880.0);
+         series = (series * x2) - (1.0 / 5040.0);
+         series = (series * x2) + (1.0 / 120.0);
+         series = (series * x2) - (1.0 / 6.0);
+         sine = x + ((x * x2) * series);
+
+         series = Doubles{} + (1.0 / 20922789888000.0);
+         series = (series * x2) - (1.0 / 87178291200.0);
+         series = (series * x2) + (1.0 / 479001600.0);
+         series = (series * x2) - (1.0 / 3628800.0);
+         series = (series * x2) + (1.0 / 40320.0);
+         series = (series * x2) - (1.0 / 720.0);
+         series = (series * x2) + (1.0 / 24.0);
+         cosine = (1.0 - (x2 * 0.5)) + ((x2 * x2) * series);
+      }
+
+      // Turns sin and cos of the reduced angle into those of the angle
+      // quadrant quarter turns further on, quadrant is 0 to 3
+      template <class Doubles>
+      UNITS_TRIG_INLINE void RotateQuadrant(const Doubles& quadrant, Doubles& sine, Doubles& cosine)
+      {
+         // One comparison per select, combined masks are done a lane at a
+         // time by GCC for 512 bit vectors without AVX512DQ
+         const Doubles reducedSine = sine;
+         const Doubles reducedCosine = cosine;
+         sine = (quadrant == 1.0) ? reducedCosine : reducedSine;
+         sine = (quadrant == 2.0) ? -reducedSine : sine;
+         sine = (quadrant == 3.0) ? -reducedCosine : sine;
+         cosine = (quadrant == 1.0) ? -reducedSine : reducedCosine;
+         cosine = (quadrant == 2.0) ? -reducedCosine : cosine;
+         cosine = (quadrant == 3.0) ? reducedSine : cosine;
+      }
+
+      // sin and cos of an N bit binary angle, phase / 2^N of a full circle.
+      // Phases are lanes of Unsigned matching the lanes of Doubles.
+      template <class Doubles, class Phases, class Unsigned>
+      UNITS_TRIG_INLINE void PhaseSinCos(const Phases& phases, Doubles& sine, Doubles& cosine)
+      {
+         constexpr int BITS = std::numeric_limits<Unsigned>::digits;
+         constexpr Unsigned HALF_QUADRANT = Unsigned(Unsigned(1) << (BITS - 3));
+         constexpr Unsigned QUADRANT_MASK = Unsigned((Unsigned(1) << (BITS - 2)) - 1);
+         constexpr double RADIANS_PER_PHASE = (2.0 * PI) / (double(HALF_QUADRANT) * 8.0);
+
+         // Nearest quadrant and the offset from it, in [0, 2^(N - 2)) shifted
+         // up by half a quadrant so it stays unsigned
+         const Phases shifted = Phases(phases + HALF_QUADRANT);
+         const Phases quadrant = Phases(shifted >> (BITS - 2));
+         const Phases offset = Phases(shifted & QUADRANT_MASK);
+
+         // Centred in signed integers so the only rounding is the one
+         // conversion to double (signed conversions also vectorize)
+         using Signed = std::conditional_t<(BITS > 32), std::int64_t, std::int32_t>;
+         typename LanesOf<Signed, Doubles>::type whole;
+         Doubles x;
+         Doubles quadrantLanes;
+         ConvertLanes(offset, whole);
+         whole = whole - Signed(HALF_QUADRANT);
+         ConvertLanes(whole, x);
+         x = x * RADIANS_PER_PHASE;
+         ConvertLanes(quadrant, whole);
+         ConvertLanes(whole, quadrantLanes);
+         SinCosReduced(x, sine, cosine);
+         RotateQuadrant(quadrantLanes, sine, cosine);
+      }
+
+      // sin and cos of angles in degrees. The nearest whole number of quarter
+      // turns is removed exactly in degrees, and only the remainder within
+      // [-45, 45] is scaled to radians. Exact below 2^47 quarter turns (about
+      // 10^16 degrees), larger magnitudes give sin 0 and cos 1, infinity and
+      // NaN give NaN.
+      template <class Doubles>
+      UNITS_TRIG_INLINE void DegreesSinCos(const Doubles& degrees, Doubles& sine, Doubles& cosine)
+      {
+         constexpr double RADIANS_PER_DEGREE = PI / 180.0;
+         constexpr double TWO_POW_47 = 140737488355328.0;
+
+         Doubles quarters = degrees * (1.0 / 90.0);
+         const Doubles magnitude = (quarters < 0.0) ? -quarters : quarters;
+         quarters = (magnitude < TWO_POW_47) ? ((quarters + ROUNDING_BIAS) - ROUNDING_BIAS) : (Doubles{} + 0.0);
+         // 90 * quarters is exact below 2^47, so is the difference
+         Doubles reduced = degrees - (quarters * 90.0);
+         reduced = (magnitude < TWO_POW_47) ? reduced : (degrees - degrees);
+
+         // Quarter turns modulo 4, in [0, 3]
+         Doubles quadrant = quarters - ((((quarters * 0.25) + ROUNDING_BIAS) - ROUNDING_BIAS) * 4.0);
+         quadrant = (quadrant < 0.0) ? (quadrant + 4.0) : quadrant;
+
+         SinCosReduced(reduced * RADIANS_PER_DEGREE, sine, cosine);
+         RotateQuadrant(quadrant, sine, cosine);
+      }
+
+      // radians = atan2(y, x) within [-pi, pi]. (0, 0) gives 0, NaN or
+      // two infinite inputs give NaN. The arctangent of the smaller over the
+      // larger magnitude is the Cephes rational approximation (within 2 ULP).
+      template <class Doubles>
+      UNITS_TRIG_INLINE void Atan2(const Doubles& y, const Doubles& x, Doubles& radians)
+      {
+         // Cephes atan.c, atan(z) = z + z^3 P(z^2) / Q(z^2) for |z| <= 0.66
+         constexpr double P0 = -8.750608600031904122785e-1;
+         constexpr double P1 = -1.615753718733365076637e1;
+         constexpr double P2 = -7.500855792314704667340e1;
+         constexpr double P3 = -1.228866684490136173410e2;
+         constexpr double P4 = -6.485021904942025371773e1;
+         constexpr double Q0 = 2.485846490142306297962e1;
+         constexpr double Q1 = 1.650270098316988542046e2;
+         constexpr double Q2 = 4.328810604912902668951e2;
+         constexpr double Q3 = 4.853903996359136964868e2;
+         constexpr double Q4 = 1.945506571482613964425e2;
+         // pi / 4 - QUARTER_PI
+         constexpr double QUARTER_PI_LOW = 3.061616997868382943065e-17;
+
+         const Doubles absoluteX = (x < 0.0) ? -x : x;
+         const Doubles absoluteY = (y < 0.0) ? -y : y;
+         const auto steep = absoluteY > absoluteX;
+         const Doubles larger = steep ? absoluteY : absoluteX;
+         const Doubles smaller = steep ? absoluteX : absoluteY;
+         const auto empty = larger == 0.0;
+         const Doubles ratio = smaller / (empty ? (Doubles{} + 1.0) : larger);
+
+         // Above 0.66, atan(ratio) = pi / 4 + atan((ratio - 1) / (ratio + 1))
+         const auto upper = ratio > 0.66;
+         const Doubles z = upper ? ((ratio - 1.0) / (ratio + 1.0)) : ratio;
+         const Doubles z2 = z * z;
+         Doubles p = (Doubles{} + P0);
+         p = (p * z2) + P1;
+         p = (p * z2) + P2;
+         p = (p * z2) + P3;
+         p = (p * z2) + P4;
+         Doubles q = z2 + Q0;
+         q = (q * z2) + Q1;
+         q = (q * z2) + Q2;
+         q = (q * z2) + Q3;
+         q = (q * z2) + Q4;
+         const Doubles arctangent = (z + (z * ((z2 * p) / q))) + (upper ? (Doubles{} + QUARTER_PI_LOW) : (Doubles{} + 0.0));
+         Doubles angle = (upper ? (Doubles{} + QUARTER_PI) : (Doubles{} + 0.0)) + arctangent;
+
+         angle = steep ? (HALF_PI - angle) : angle;
+         angle = (x < 0.0) ? (PI - angle) : angle;
+         angle = (y < 0.0) ? -angle : angle;
+         radians = empty ? (Doubles{} + 0.0) : angle;
+      }
+
+      // Radians in [-pi, pi] to the nearest N bit phase, NaN gives 0
+      template <class Phases, class Unsigned, class Doubles>
+      UNITS_TRIG_INLINE void RadiansToPhase(const Doubles& radians, Phases& result)
+      {
+         constexpr int BITS = std::numeric_limits<Unsigned>::digits;
+         constexpr double HALF_CIRCLE = double(Unsigned(1) << (BITS - 1));
+         constexpr double PHASES_PER_RADIAN = HALF_CIRCLE / PI;
+         using Signed = std::conditional_t<(BITS > 32), std::int64_t, std::int32_t>;
+
+         Doubles phases = radians * PHASES_PER_RADIAN;
+         phases = (phases == phases) ? phases : (Doubles{} + 0.0);
+         const Doubles magnitude = (phases < 0.0) ? -phases : phases;
+         phases = (magnitude < TWO_POW_51) ? ((phases + ROUNDING_BIAS) - ROUNDING_BIAS) : phases;
+         // +pi is the same phase as -pi
+         phases = (phases >= HALF_CIRCLE) ? (phases - (2.0 * HALF_CIRCLE)) : phases;
+         typename LanesOf<Signed, Doubles>::type whole;
+         ConvertLanes(phases, whole);
+         ConvertLanes(whole, result);
+      }
+   } //end namespace Trigonometry
+} //end namespace Units
+
+#endif  // TRIGONOMETRY_H_GUARD
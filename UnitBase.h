@@ -16,100 +16,88 @@ See the License for the specific language governing permissionsand
 limitations under the License.
 */
 
-#include <iostream>
+#include <cmath>
+#include <iosfwd>
+#include <ratio>
+#include <string_view>
+#include <type_traits>
 
+// Functions defined out of line in the .cpp files are declared UNITS_INLINE.
+// Define UNITS_HEADER_ONLY to have each header pull in its matching .cpp so the
+// functions are inline at every call site. Without it the .cpp files are
+// compiled once as a library. Every translation unit of a program must agree
+// on the setting.
+#ifdef UNITS_HEADER_ONLY
+#define UNITS_INLINE inline
+#else
+#define UNITS_INLINE
+#endif
+
+// Every base dimension and every unit built on it is a literal type holding a
+// single value in the storage type of its representation (a double unless
+// asked otherwise). The copy/move operations and destructor are left implicit
+// so the types stay trivially copyable and standard layout, which lets arrays
+// of units be memcpy'd and treated by the optimizer as plain numbers.
 #define GENERIC_OPERATORS(T) \
    public: \
       /*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */\
       /* Constructors / Destructors                                             */\
       /*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */\
-      T() : m_value(0.0) {}\
-      T(const T & rhs) { m_value = rhs.BaseValue(); }\
-      T(const T && rhs) { m_value = rhs.BaseValue(); }\
-      ~T() {}\
+      constexpr T() : m_value() {}\
 \
       /* Function to always return zero                                        */\
       /* This is a common value to checkand use of this function will prevent  */\
       /* the need to instantiate a class just to check against 0               */\
-      static T zero() { return T(0.0); }\
-\
-      T& operator=(const T& rhs)\
-      {\
-         if (&rhs != this)\
-         {\
-            m_value = rhs.BaseValue();\
-         }\
+      static constexpr T zero() { return T(storage_type()); }\
 \
-         return *this;\
-      }\
-      T& operator=(const T&& rhs) noexcept\
+      constexpr T& operator+=(const T& rhs)\
       {\
-         if (&rhs != this)\
-         {\
-            m_value = rhs.BaseValue();\
-         }\
+         m_value = representation::Add(m_value, rhs.m_value);\
 \
          return *this;\
       }\
-      T& operator+=(const T& rhs)\
+      constexpr T& operator-=(const T& rhs)\
       {\
-         if (&rhs != this)\
-         {\
-            m_value += rhs.BaseValue();\
-         }\
+         m_value = representation::Subtract(m_value, rhs.m_value);\
 \
          return *this;\
       }\
-      T& operator-=(const T& rhs)\
-      {\
-         if (&rhs != this)\
-         {\
-            m_value -= rhs.BaseValue();\
-         }\
-\
-         return *this;\
-      }\
-\
-      operator T() const\
-      {\
-         return T(m_value);\
-      }\
 \
-      T operator+(const T& rhs) const\
+      constexpr T operator+(const T& rhs) const\
       {\
-         return T(m_value + rhs.BaseValue());\
+         return T(representation::Add(m_value, rhs.m_value));\
       }\
 \
-      T operator-(const T& rhs) const\
+      constexpr T operator-(const T& rhs) const\
       {\
-         return T(m_value - rhs.BaseValue());\
+         return T(representation::Subtract(m_value, rhs.m_value));\
       }\
 \
-      T operator+() const\
+      constexpr T operator+() const\
       {\
          return T(m_value);\
       }\
-      T operator-() const\
+      constexpr T operator-() const\
       {\
-         return T(-m_value);\
+         return T(representation::Negate(m_value));\
       }\
 \
-      bool operator< (const T& rhs) const { return m_value <  rhs.m_value; }\
-      bool operator> (const T& rhs) const { return m_value >  rhs.m_value; }\
-      bool operator<=(const T& rhs) const { return m_value <= rhs.m_value; }\
-      bool operator>=(const T& rhs) const { return m_value >= rhs.m_value; }\
-      bool operator==(const T& rhs) const { return m_value == rhs.m_value; }\
-      bool operator!=(const T& rhs) const { return m_value != rhs.m_value; }\
-      bool operator< (double rhs) const { return value() < rhs; }\
-      bool operator> (double rhs) const { return value() > rhs; }\
-      bool operator<=(double rhs) const { return value() <= rhs; }\
-      bool operator>=(double rhs) const { return value() >= rhs; }\
-      bool operator==(double rhs) const { return value() == rhs; }\
-      bool operator!=(double rhs) const { return value() != rhs; }\
+      constexpr bool operator< (const T& rhs) const { return m_value <  rhs.m_value; }\
+      constexpr bool operator> (const T& rhs) const { return m_value >  rhs.m_value; }\
+      constexpr bool operator<=(const T& rhs) const { return m_value <= rhs.m_value; }\
+      constexpr bool operator>=(const T& rhs) const { return m_value >= rhs.m_value; }\
+      constexpr bool operator==(const T& rhs) const { return m_value == rhs.m_value; }\
+      constexpr bool operator!=(const T& rhs) const { return m_value != rhs.m_value; }\
+      constexpr bool operator< (double rhs) const { return value() < rhs; }\
+      constexpr bool operator> (double rhs) const { return value() > rhs; }\
+      constexpr bool operator<=(double rhs) const { return value() <= rhs; }\
+      constexpr bool operator>=(double rhs) const { return value() >= rhs; }\
+      constexpr bool operator==(double rhs) const { return value() == rhs; }\
+      constexpr bool operator!=(double rhs) const { return value() != rhs; }\
 \
    protected:\
-      T(double rhs) : m_value(rhs) {}\
-      T& operator=(const double& rhs)\
+      explicit constexpr T(storage_type rhs) : m_value(rhs) {}\
+      constexpr T& operator=(const storage_type& rhs)\
       {\
          m_value = rhs;\
 \
@@ -119,53 +107,307 @@ limitations under the License.
       /*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/\
       /* Operator Override Methods */\
       /*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/\
-      double BaseValue() const { return m_value; }\
-      double value() const { return m_value; }\
+      constexpr value_type BaseValue() const { return representation::template ToFloating<value_type>(m_value); }\
+      constexpr value_type value() const { return representation::template ToFloating<value_type>(m_value); }\
       /* This assumes the base type and only used if not created as a specific unit */\
-      void SetValue(double input) { m_value = input; }\
+      constexpr void SetValue(value_type input) { m_value = representation::template FromFloating<value_type>(input); }\
 \
-      double m_value;
+      storage_type m_value;
 
 
-#define UNIT_TEMPLATE_EQUATION(Base, TypeName, equation_to_base, equation_from_base, userliteral)\
+// Compile time guarantees shared by every base and unit type, a unit must be
+// interchangeable with a bare double in memory
+#define UNIT_LAYOUT_CHECKS(TypeName)\
+static_assert(sizeof(Units::TypeName) == sizeof(double), #TypeName " must be the same size as double");\
+static_assert(std::is_trivially_copyable_v<Units::TypeName>, #TypeName " must be trivially copyable");\
+static_assert(std::is_standard_layout_v<Units::TypeName>, #TypeName " must be standard layout");
+
+
+namespace Units
+{
+   // Exponents of the base dimensions making up a quantity, Speed is
+   // Dimension<1, 0, -1, 0, 0> (length / time)
+   template <int LengthExponent, int MassExponent, int TimeExponent, int TemperatureExponent, int AngleExponent>
+   struct Dimension
+   {
+      static constexpr int length = LengthExponent;
+      static constexpr int mass = MassExponent;
+      static constexpr int time = TimeExponent;
+      static constexpr int temperature = TemperatureExponent;
+      static constexpr int angle = AngleExponent;
+
+      static constexpr bool dimensionless = (length == 0) && (mass == 0) && (time == 0) && (temperature == 0) && (angle == 0);
+   };
+
+   template <class Lhs, class Rhs>
+   using DimensionProduct = Dimension<Lhs::length + Rhs::length, Lhs::mass + Rhs::mass, Lhs::time + Rhs::time,
+      Lhs::temperature + Rhs::temperature, Lhs::angle + Rhs::angle>;
+
+   template <class Lhs, class Rhs>
+   using DimensionQuotient = Dimension<Lhs::length - Rhs::length, Lhs::mass - Rhs::mass, Lhs::time - Rhs::time,
+      Lhs::temperature - Rhs::temperature, Lhs::angle - Rhs::angle>;
+
+   // How a Quantity stores its base unit value. Floating point types hold it
+   // directly, FixedPoint.h adds whole numbers of a fixed scale.
+   template <class Rep>
+   struct Representation
+   {
+      static_assert(std::is_floating_point_v<Rep>, "representation must be a floating point type or a FixedPoint");
+
+      using storage_type = Rep;
+      using value_type = Rep;      // type value() works in
+      static constexpr bool floating = true;
+
+      static constexpr Rep Add(Rep lhs, Rep rhs) { return lhs + rhs; }
+      static constexpr Rep Subtract(Rep lhs, Rep rhs) { return lhs - rhs; }
+      static constexpr Rep Negate(Rep value) { return -value; }
+
+      template <class Floating>
+      static constexpr Floating ToFloating(Rep value) { return Floating(value); }
+      template <class Floating>
+      static constexpr Rep FromFloating(Floating value) { return Rep(value); }
+
+      // From the storage of another representation, rounded to nearest
+      template <class OtherRep>
+      static constexpr Rep Convert(typename Representation<OtherRep>::storage_type other)
+      {
+         return Representation<OtherRep>::template ToFloating<Rep>(other);
+      }
+   };
+
+   // Specialize to give every quantity of a dimension extra members, see Angle.
+   // Derived is the Quantity itself.
+   template <class Dim, class Derived>
+   class DimensionMembers
+   {
+   };
+
+   // A value of a dimension held in its base unit. Base units are the coherent
+   // SI units (meters, kilograms, seconds, newtons, pascals, watts ...) with
+   // degrees for angles, so every product or quotient of two quantities lands
+   // directly in the base unit of the result and costs a single multiply or
+   // divide with no scale factor. Dimensionless results are returned as the
+   // representation's type. Rep is how the value is stored, see Representation.
+   template <class Dim, class Rep = double>
+   class Quantity : public DimensionMembers<Dim, Quantity<Dim, Rep>>
+   {
+      template <class OtherDim, class OtherRep>
+      friend class Quantity;
+      friend class DimensionMembers<Dim, Quantity>;
+
+   public:
+      using dimension = Dim;
+      using representation = Representation<Rep>;
+      using storage_type = typename representation::storage_type;
+      using value_type = typename representation::value_type;
+
+      // Explicit conversion from another representation of the dimension.
+      // Narrowing rounds to nearest (a double beyond the float range becomes
+      // infinity), widening is exact. FixedPoint overflow follows its
+      // Overflow mode.
+      template <class OtherRep>
+         requires (!std::is_same_v<OtherRep, Rep>)
+      explicit constexpr Quantity(const Quantity<Dim, OtherRep>& other)
+         : m_value(representation::template Convert<OtherRep>(other.m_value))
+      {
+      }
+
+      template <class OtherDim>
+         requires representation::floating
+      constexpr auto operator*(const Quantity<OtherDim, Rep>& rhs) const
+      {
+         return Make<DimensionProduct<Dim, OtherDim>>(m_value * rhs.m_value);
+      }
+      template <class OtherDim>
+         requires representation::floating
+      constexpr auto operator/(const Quantity<OtherDim, Rep>& rhs) const
+      {
+         return Make<DimensionQuotient<Dim, OtherDim>>(m_value / rhs.m_value);
+      }
+
+      // Value in Unit (a unit of this dimension) worked out in this
+      // representation, so long double keeps its extra precision through
+      // exact ratios such as AstronomicalUnits and Picometers. Units that are
+      // not affine (decibels) convert through double.
+      template <class Unit>
+         requires representation::floating
+      constexpr storage_type ValueIn() const
+      {
+         static_assert(std::is_same_v<typename Unit::dimension, Dim>, "unit is of another dimension");
+         if constexpr (requires { typename Unit::exact_ratio; })
+         {
+            return m_value * (storage_type(Unit::exact_ratio::den) / storage_type(Unit::exact_ratio::num));
+         }
+         else if constexpr (Unit::affine)
+         {
+            return (m_value - storage_type(Unit::offset)) * (storage_type(1) / storage_type(Unit::scale));
+         }
+         else
+         {
+            return storage_type(Unit(Quantity<Dim>(double(m_value))).value());
+         }
+      }
+      template <class Unit>
+         requires representation::floating
+      static constexpr Quantity FromValue(storage_type value)
+      {
+         static_assert(std::is_same_v<typename Unit::dimension, Dim>, "unit is of another dimension");
+         if constexpr (requires { typename Unit::exact_ratio; })
+         {
+            return Quantity(value * (storage_type(Unit::exact_ratio::num) / storage_type(Unit::exact_ratio::den)));
+         }
+         else if constexpr (Unit::affine && (Unit::offset == 0.0))
+         {
+            return Quantity(value * storage_type(Unit::scale));
+         }
+         else if constexpr (Unit::affine)
+         {
+            return Quantity((value * storage_type(Unit::scale)) + storage_type(Unit::offset));
+         }
+         else
+         {
+            return Quantity(storage_type(static_cast<const Quantity<Dim>&>(Unit(double(value))).m_value));
+         }
+      }
+
+      // Whole number of scale units held by a FixedPoint quantity
+      constexpr storage_type Count() const
+         requires (!representation::floating)
+      {
+         return m_value;
+      }
+      static constexpr Quantity FromCount(storage_type count)
+         requires (!representation::floating)
+      {
+         return Quantity(count);
+      }
+      constexpr Quantity operator*(storage_type rhs) const
+         requires (!representation::floating)
+      {
+         return Quantity(representation::Multiply(m_value, rhs));
+      }
+      constexpr Quantity operator/(storage_type rhs) const
+         requires (!representation::floating)
+      {
+         return Quantity(representation::Divide(m_value, rhs));
+      }
+
+      GENERIC_OPERATORS(Quantity)
+
+   private:
+      template <class ResultDim>
+      static constexpr auto Make(storage_type value)
+      {
+         if constexpr (ResultDim::dimensionless)
+         {
+            return value;
+         }
+         else
+         {
+            return Quantity<ResultDim, Rep>(value);
+         }
+      }
+   };
+
+   // The dimension of QuantityType stored another way, e.g.
+   // RepresentedAs<Time, FixedPoint<std::int64_t, std::nano>>
+   template <class QuantityType, class Rep>
+   using RepresentedAs = Quantity<typename QuantityType::dimension, Rep>;
+
+   // Quantities and units held as a base unit double, and double itself.
+   // Arrays, files and parsers of these are read and written as doubles, a
+   // FixedPoint or binary angle of the same size holds counts instead.
+   template <class T>
+   concept StoredAsDouble = std::is_same_v<T, double> || std::is_same_v<typename T::storage_type, double>;
+} //end namespace Units
+
+
+// Shared body of the UNIT_TEMPLATE macros, the trailing arguments are member
+// declarations describing the conversion to the base unit for Units::convert
+#define UNIT_TEMPLATE_CLASS(Base, TypeName, equation_to_base, equation_from_base, userliteral, ...)\
 namespace Units\
 {\
    class TypeName : public Base\
    {\
    public:\
-      TypeName() : Base(0.0) {}\
-      TypeName(const Base& rhs) : Base(rhs) { }\
-      TypeName(const Base&& rhs) : Base(rhs) { }\
+      __VA_ARGS__\
+      static constexpr std::string_view suffix = #userliteral;\
+   \
+      constexpr TypeName() : Base(0.0) {}\
+      constexpr TypeName(const Base& rhs) : Base(rhs) { }\
    \
-      TypeName(double input) { m_value = (equation_to_base); }\
-      ~TypeName() {}\
+      constexpr TypeName(double input) : Base(equation_to_base) { }\
    \
-      TypeName operator*(double rhs) const { return TypeName(value() * rhs); }\
-      TypeName operator/(double rhs) const { return TypeName(value() / rhs); }\
+      /* Keep the cross-dimension operators visible next to the scalar ones */\
+      using Base::operator*;\
+      using Base::operator/;\
+      constexpr TypeName operator*(double rhs) const { return TypeName(value() * rhs); }\
+      constexpr TypeName operator/(double rhs) const { return TypeName(value() / rhs); }\
    \
-      double value() const { return (equation_from_base); }\
-      operator double() const { return value(); }\
+      constexpr double value() const { return (equation_from_base); }\
+      constexpr operator double() const { return value(); }\
    \
-      void SetValue(double input) { m_value = (equation_to_base); }\
+      constexpr void SetValue(double input) { m_value = (equation_to_base); }\
    };\
 \
    namespace Literals\
    {\
-      inline Units::TypeName operator"" _##userliteral(unsigned long long int rhs) { return Units::TypeName(double(rhs)); } \
-      inline Units::TypeName operator"" _##userliteral(long double rhs) { return Units::TypeName(rhs); }\
+      constexpr Units::TypeName operator"" _##userliteral(unsigned long long int rhs) { return Units::TypeName(double(rhs)); } \
+      constexpr Units::TypeName operator"" _##userliteral(long double rhs) { return Units::TypeName(double(rhs)); }\
    }\
 \
 } /* end namespace Units */\
 \
-inline std::ostream& operator<<(std::ostream& os, const Units::TypeName& unit)\
+UNIT_LAYOUT_CHECKS(Base)\
+UNIT_LAYOUT_CHECKS(TypeName)\
+\
+/* A template so only <iosfwd> is needed here, streaming needs <ostream> */\
+template <class CharT, class Traits>\
+std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const Units::TypeName& unit)\
 {\
    os << unit.value() << #userliteral;\
    return os;\
 }
 
+// Any conversion to and from the base unit, e.g. logarithmic units
+#define UNIT_TEMPLATE_EQUATION(Base, TypeName, equation_to_base, equation_from_base, userliteral)\
+UNIT_TEMPLATE_CLASS(Base, TypeName, equation_to_base, equation_from_base, userliteral,\
+   static constexpr bool affine = false;)
+
+// base = reference_in_base * 10^(input / 10), decibels of power relative to a
+// reference level, e.g. dBm
+#define UNIT_TEMPLATE_DECIBEL(Base, TypeName, reference_in_base, userliteral)\
+static_assert(reference_in_base > 0.0, "reference level must be positive");\
+UNIT_TEMPLATE_CLASS(Base, TypeName, (std::pow(10.0, (input / 10.0)) * (reference_in_base)), (10.0 * std::log10(m_value * (1.0 / (reference_in_base)))), userliteral,\
+   static constexpr bool affine = false;\
+   static constexpr bool decibel = true;\
+   static constexpr double reference = (reference_in_base);)
+
+// base = (input * scale_to_base) + offset_to_base, e.g. temperature scales
+#define UNIT_TEMPLATE_AFFINE(Base, TypeName, scale_to_base, offset_to_base, userliteral)\
+static_assert(scale_to_base != 0.0, "zero scale not allowed");\
+UNIT_TEMPLATE_CLASS(Base, TypeName, ((input * (scale_to_base)) + (offset_to_base)), ((m_value - (offset_to_base)) * (1.0 / (scale_to_base))), userliteral,\
+   static constexpr bool affine = true;\
+   static constexpr double scale = (scale_to_base);\
+   static constexpr double offset = (offset_to_base);)
+
+// base = input * ratio
 #define UNIT_TEMPLATE(Base, TypeName, ratio, userliteral)\
 static_assert(ratio != 0.0, "zero ratio not allowed");\
-UNIT_TEMPLATE_EQUATION(Base, TypeName, (input * (ratio)), (m_value * (1.0 / ratio)), userliteral)
+UNIT_TEMPLATE_CLASS(Base, TypeName, (input * (ratio)), (m_value * (1.0 / ratio)), userliteral,\
+   static constexpr bool affine = true;\
+   static constexpr double scale = (ratio);\
+   static constexpr double offset = 0.0;)
+
+// base = input * (numerator / denominator), an exact ratio that Units::convert
+// composes with other exact ratios before rounding to double
+#define UNIT_TEMPLATE_RATIO(Base, TypeName, numerator, denominator, userliteral)\
+static_assert((numerator) > 0 && (denominator) > 0, "ratio must be positive");\
+UNIT_TEMPLATE_CLASS(Base, TypeName, (input * (double(numerator) / double(denominator))), (m_value * (double(denominator) / double(numerator))), userliteral,\
+   static constexpr bool affine = true;\
+   static constexpr double scale = double(numerator) / double(denominator);\
+   static constexpr double offset = 0.0;\
+   using exact_ratio = std::ratio<(numerator), (denominator)>;)
 
 
 #endif  // UNITBASE_H_GUARD
@@ -0,0 +1,1668 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#ifndef UNITBATCH_CPP_GUARD
+#define UNITBATCH_CPP_GUARD
+
+#include "UnitBatch.h"
+#include "AngleType.h"
+#include "Trigonometry.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define UNITS_BATCH_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define UNITS_TARGET(isa)
+#else
+#define UNITS_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+#if defined(UNITS_BATCH_X86) && defined(__GNUC__)
+// Stops GCC and Clang fusing the multiply and the add into an FMA on targets
+// that have one, every kernel must round after the multiply the way SSE2 does
+#define UNITS_ROUND_PRODUCT(value) __asm__("" : "+v"(value))
+#else
+#define UNITS_ROUND_PRODUCT(value)
+#endif
+
+#if defined(UNITS_BATCH_X86) && defined(__GNUC__)
+// The logarithmic kernels are written once over GCC / Clang vector types,
+// which compile to the instruction set of whichever kernel inlines them
+#define UNITS_BATCH_LANES
+#define UNITS_LANES_INLINE inline __attribute__((always_inline))
+#else
+#define UNITS_LANES_INLINE inline
+#endif
+
+namespace Units
+{
+   namespace BatchKernels
+   {
+      // Values to handle one at a time before output reaches the vector alignment
+      template <class Value>
+      inline std::size_t HeadCount(const Value* output, std::size_t count, std::size_t alignment)
+      {
+         const std::size_t misalignment = std::size_t(reinterpret_cast<std::uintptr_t>(output) % alignment);
+         const std::size_t head = (misalignment == 0) ? 0 : ((alignment - misalignment) / sizeof(Value));
+
+         return (head < count) ? head : count;
+      }
+
+      template <bool Affine, class Value>
+      inline void Scalar(const Value* input, Value* output, std::size_t count, Value factor, Value offset)
+      {
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            Value value = input[i] * factor;
+            if constexpr (Affine)
+            {
+               UNITS_ROUND_PRODUCT(value);
+               value += offset;
+            }
+            output[i] = value;
+         }
+      }
+
+      // sqrt(x^2 + y^2 + z^2), each square rounded before it is added so
+      // every kernel gives the same bits
+      inline void NormScalar(const double* x, const double* y, const double* z, double* norms, std::size_t count)
+      {
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            double xx = x[i] * x[i];
+            double yy = y[i] * y[i];
+            double zz = z[i] * z[i];
+            UNITS_ROUND_PRODUCT(xx);
+            UNITS_ROUND_PRODUCT(yy);
+            UNITS_ROUND_PRODUCT(zz);
+            norms[i] = std::sqrt((xx + yy) + zz);
+         }
+      }
+
+#ifdef UNITS_BATCH_X86
+      template <bool Affine>
+      UNITS_TARGET("sse2") inline void SSE2(const double* input, double* output, std::size_t count, double factor, double offset)
+      {
+         const std::size_t head = HeadCount(output, count, sizeof(__m128d));
+         Scalar<Affine>(input, output, head, factor, offset);
+
+         const __m128d factors = _mm_set1_pd(factor);
+         const __m128d offsets = _mm_set1_pd(offset);
+         std::size_t i = head;
+         for (; (i + 2) <= count; i += 2)
+         {
+            __m128d values = _mm_mul_pd(_mm_loadu_pd(input + i), factors);
+            if constexpr (Affine)
+            {
+               UNITS_ROUND_PRODUCT(values);
+               values = _mm_add_pd(values, offsets);
+            }
+            _mm_store_pd(output + i, values);
+         }
+
+         Scalar<Affine>(input + i, output + i, count - i, factor, offset);
+      }
+
+      template <bool Affine>
+      UNITS_TARGET("avx2") inline void AVX2(const double* input, double* output, std::size_t count, double factor, double offset)
+      {
+         const std::size_t head = HeadCount(output, count, sizeof(__m256d));
+         Scalar<Affine>(input, output, head, factor, offset);
+
+         const __m256d factors = _mm256_set1_pd(factor);
+         const __m256d offsets = _mm256_set1_pd(offset);
+         std::size_t i = head;
+         for (; (i + 4) <= count; i += 4)
+         {
+            __m256d values = _mm256_mul_pd(_mm256_loadu_pd(input + i), factors);
+            if constexpr (Affine)
+            {
+               UNITS_ROUND_PRODUCT(values);
+               values = _mm256_add_pd(values, offsets);
+            }
+            _mm256_store_pd(output + i, values);
+         }
+
+         Scalar<Affine>(input + i, output + i, count - i, factor, offset);
+      }
+
+      template <bool Affine>
+      UNITS_TARGET("avx512f") inline void AVX512(const double* input, double* output, std::size_t count, double factor, double offset)
+      {
+         const std::size_t head = HeadCount(output, count, sizeof(__m512d));
+         Scalar<Affine>(input, output, head, factor, offset);
+
+         const __m512d factors = _mm512_set1_pd(factor);
+         const __m512d offsets = _mm512_set1_pd(offset);
+         std::size_t i = head;
+         for (; (i + 8) <= count; i += 8)
+         {
+            __m512d values = _mm512_mul_pd(_mm512_loadu_pd(input + i), factors);
+            if constexpr (Affine)
+            {
+               UNITS_ROUND_PRODUCT(values);
+               values = _mm512_add_pd(values, offsets);
+            }
+            _mm512_store_pd(output + i, values);
+         }
+
+         Scalar<Affine>(input + i, output + i, count - i, factor, offset);
+      }
+
+      // Single precision versions of the kernels above
+      template <bool Affine>
+      UNITS_TARGET("sse2") inline void SSE2(const float* input, float* output, std::size_t count, float factor, float offset)
+      {
+         const std::size_t head = HeadCount(output, count, sizeof(__m128));
+         Scalar<Affine>(input, output, head, factor, offset);
+
+         const __m128 factors = _mm_set1_ps(factor);
+         const __m128 offsets = _mm_set1_ps(offset);
+         std::size_t i = head;
+         for (; (i + 4) <= count; i += 4)
+         {
+            __m128 values = _mm_mul_ps(_mm_loadu_ps(input + i), factors);
+            if constexpr (Affine)
+            {
+               UNITS_ROUND_PRODUCT(values);
+               values = _mm_add_ps(values, offsets);
+            }
+            _mm_store_ps(output + i, values);
+         }
+
+         Scalar<Affine>(input + i, output + i, count - i, factor, offset);
+      }
+
+      template <bool Affine>
+      UNITS_TARGET("avx2") inline void AVX2(const float* input, float* output, std::size_t count, float factor, float offset)
+      {
+         const std::size_t head = HeadCount(output, count, sizeof(__m256));
+         Scalar<Affine>(input, output, head, factor, offset);
+
+         const __m256 factors = _mm256_set1_ps(factor);
+         const __m256 offsets = _mm256_set1_ps(offset);
+         std::size_t i = head;
+         for (; (i + 8) <= count; i += 8)
+         {
+            __m256 values = _mm256_mul_ps(_mm256_loadu_ps(input + i), factors);
+            if constexpr (Affine)
+            {
+               UNITS_ROUND_PRODUCT(values);
+               values = _mm256_add_ps(values, offsets);
+            }
+            _mm256_store_ps(output + i, values);
+         }
+
+         Scalar<Affine>(input + i, output + i, count - i, factor, offset);
+      }
+
+      template <bool Affine>
+      UNITS_TARGET("avx512f") inline void AVX512(const float* input, float* output, std::size_t count, float factor, float offset)
+      {
+         const std::size_t head = HeadCount(output, count, sizeof(__m512));
+         Scalar<Affine>(input, output, head, factor, offset);
+
+         const __m512 factors = _mm512_set1_ps(factor);
+         const __m512 offsets = _mm512_set1_ps(offset);
+         std::size_t i = head;
+         for (; (i + 16) <= count; i += 16)
+         {
+            __m512 values = _mm512_mul_ps(_mm512_loadu_ps(input + i), factors);
+            if constexpr (Affine)
+            {
+               UNITS_ROUND_PRODUCT(values);
+               values = _mm512_add_ps(values, offsets);
+            }
+            _mm512_store_ps(output + i, values);
+         }
+
+         Scalar<Affine>(input + i, output + i, count - i, factor, offset);
+      }
+
+      UNITS_TARGET("sse2") inline void NormSSE2(const double* x, const double* y, const double* z, double* norms, std::size_t count)
+      {
+         std::size_t i = 0;
+         for (; (i + 2) <= count; i += 2)
+         {
+            const __m128d xs = _mm_loadu_pd(x + i);
+            const __m128d ys = _mm_loadu_pd(y + i);
+            const __m128d zs = _mm_loadu_pd(z + i);
+            __m128d xx = _mm_mul_pd(xs, xs);
+            __m128d yy = _mm_mul_pd(ys, ys);
+            __m128d zz = _mm_mul_pd(zs, zs);
+            UNITS_ROUND_PRODUCT(xx);
+            UNITS_ROUND_PRODUCT(yy);
+            UNITS_ROUND_PRODUCT(zz);
+            _mm_storeu_pd(norms + i, _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(xx, yy), zz)));
+         }
+
+         NormScalar(x + i, y + i, z + i, norms + i, count - i);
+      }
+
+      UNITS_TARGET("avx2") inline void NormAVX2(const double* x, const double* y, const double* z, double* norms, std::size_t count)
+      {
+         std::size_t i = 0;
+         for (; (i + 4) <= count; i += 4)
+         {
+            const __m256d xs = _mm256_loadu_pd(x + i);
+            const __m256d ys = _mm256_loadu_pd(y + i);
+            const __m256d zs = _mm256_loadu_pd(z + i);
+            __m256d xx = _mm256_mul_pd(xs, xs);
+            __m256d yy = _mm256_mul_pd(ys, ys);
+            __m256d zz = _mm256_mul_pd(zs, zs);
+            UNITS_ROUND_PRODUCT(xx);
+            UNITS_ROUND_PRODUCT(yy);
+            UNITS_ROUND_PRODUCT(zz);
+            _mm256_storeu_pd(norms + i, _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(xx, yy), zz)));
+         }
+
+         NormScalar(x + i, y + i, z + i, norms + i, count - i);
+      }
+
+      UNITS_TARGET("avx512f") inline void NormAVX512(const double* x, const double* y, const double* z, double* norms, std::size_t count)
+      {
+         std::size_t i = 0;
+         for (; (i + 8) <= count; i += 8)
+         {
+            const __m512d xs = _mm512_loadu_pd(x + i);
+            const __m512d ys = _mm512_loadu_pd(y + i);
+            const __m512d zs = _mm512_loadu_pd(z + i);
+            __m512d xx = _mm512_mul_pd(xs, xs);
+            __m512d yy = _mm512_mul_pd(ys, ys);
+            __m512d zz = _mm512_mul_pd(zs, zs);
+            UNITS_ROUND_PRODUCT(xx);
+            UNITS_ROUND_PRODUCT(yy);
+            UNITS_ROUND_PRODUCT(zz);
+            // maskz with every lane set is the plain sqrt, _mm512_sqrt_pd
+            // trips a false -Wmaybe-uninitialized in GCC 12
+            _mm512_storeu_pd(norms + i, _mm512_maskz_sqrt_pd(__mmask8(0xFF), _mm512_add_pd(_mm512_add_pd(xx, yy), zz)));
+         }
+
+         NormScalar(x + i, y + i, z + i, norms + i, count - i);
+      }
+#endif
+
+      // Decibels per factor of two, split so (octaves * HIGH) is exact for any
+      // octave count a double can reach
+      constexpr double DECIBELS_PER_OCTAVE_HIGH = 3.0102999564260244;
+      constexpr double DECIBELS_PER_OCTAVE_LOW = 2.1378751518670535e-10;
+      constexpr double OCTAVES_PER_DECIBEL = 0.33219280948873625;
+      constexpr double NEPERS_PER_DECIBEL = 0.23025850929940456; // ln(10) / 10
+      constexpr double DECIBELS_PER_NEPER = 4.342944819032518; // 10 / ln(10)
+      // Adding then subtracting 1.5 * 2^52 rounds to the nearest whole number
+      constexpr double ROUNDING_BIAS = 6755399441055744.0;
+      constexpr double TWO_POW_52 = 4503599627370496.0;
+      constexpr double SQRT2 = 1.4142135623730951;
+      constexpr std::uint64_t MANTISSA_BITS = 0x000FFFFFFFFFFFFFull;
+      constexpr std::uint64_t ONE_BITS = 0x3FF0000000000000ull;
+      constexpr std::uint64_t TWO_POW_52_BITS = 0x4330000000000000ull;
+
+      // The lane functions below take vectors by reference only, a vector
+      // passed by value is an ABI change GCC warns about on every target
+
+      // Same bits as another type of the same size
+      template <class To, class From>
+      UNITS_LANES_INLINE void Reinterpret(To& to, const From& from)
+      {
+         std::memcpy(&to, &from, sizeof(to));
+      }
+
+      // 2^octaves for whole octaves in [-1022, 1023], built in the exponent field
+      template <class Doubles, class Bits>
+      UNITS_LANES_INLINE void PowerOfTwo(Doubles& power, const Doubles& octaves)
+      {
+         Bits bits;
+         Reinterpret(bits, octaves + (ROUNDING_BIAS + 1023.0));
+         Reinterpret(power, bits << 52);
+      }
+
+      // 10^(decibels / 10) in place, as 2^octaves * e^nepers with
+      // |nepers| <= ln(2) / 2 and e^nepers its Taylor series to degree 13
+      // (Strict) or 7 (Fast)
+      template <class Doubles, class Bits, bool Strict>
+      UNITS_LANES_INLINE void Exp10Decibels(Doubles& values)
+      {
+         // Past +-3300 dB every result is infinity or zero, clamping keeps the
+         // octave arithmetic finite (NaN fails both compares and stays NaN)
+         const Doubles maxDecibels = Doubles{} + 3300.0;
+         const Doubles minDecibels = Doubles{} - 3300.0;
+         Doubles decibels = (values > maxDecibels) ? maxDecibels : values;
+         decibels = (decibels < minDecibels) ? minDecibels : decibels;
+
+         const Doubles octaves = ((decibels * OCTAVES_PER_DECIBEL) + ROUNDING_BIAS) - ROUNDING_BIAS;
+         const Doubles remainder = (decibels - (octaves * DECIBELS_PER_OCTAVE_HIGH)) - (octaves * DECIBELS_PER_OCTAVE_LOW);
+         const Doubles nepers = remainder * NEPERS_PER_DECIBEL;
+
+         Doubles series;
+         if constexpr (Strict)
+         {
+            series = Doubles{} + (1.0 / 6227020800.0);
+            series = (series * nepers) + (1.0 / 479001600.0);
+            series = (series * nepers) + (1.0 / 39916800.0);
+            series = (series * nepers) + (1.0 / 3628800.0);
+            series = (series * nepers) + (1.0 / 362880.0);
+            series = (series * nepers) + (1.0 / 40320.0);
+            series = (series * nepers) + (1.0 / 5040.0);
+         }
+         else
+         {
+            series = Doubles{} + (1.0 / 5040.0);
+         }
+         series = (series * nepers) + (1.0 / 720.0);
+         series = (series * nepers) + (1.0 / 120.0);
+         series = (series * nepers) + (1.0 / 24.0);
+         series = (series * nepers) + (1.0 / 6.0);
+         series = (series * nepers) + 0.5;
+         series = (series * nepers) + 1.0;
+         series = (series * nepers) + 1.0;
+
+         // Applied as two powers of two so results just below the largest
+         // double and down into the subnormals come out right, the first
+         // product is exact
+         const Doubles maxOctaves = Doubles{} + 1023.0;
+         const Doubles minOctaves = Doubles{} - 1022.0;
+         Doubles first = (octaves > maxOctaves) ? maxOctaves : octaves;
+         first = (first < minOctaves) ? minOctaves : first;
+         Doubles second = octaves - first;
+         second = (second < minOctaves) ? minOctaves : second;
+
+         Doubles firstPower;
+         Doubles secondPower;
+         PowerOfTwo<Doubles, Bits>(firstPower, first);
+         PowerOfTwo<Doubles, Bits>(secondPower, second);
+         values = (series * firstPower) * secondPower;
+      }
+
+      // 10 * log10(ratio) in place, as octaves * 10 * log10(2) plus
+      // 10 / ln(10) * ln(mantissa) with the mantissa in [sqrt(1/2), sqrt(2)].
+      // ln(mantissa) = 2 * atanh(s) for s = (mantissa - 1) / (mantissa + 1), a
+      // series in s to degree 21 (Strict) or 11 (Fast).
+      template <class Doubles, class Bits, bool Strict>
+      UNITS_LANES_INLINE void Log10Decibels(Doubles& values)
+      {
+         const Doubles ratio = values;
+
+         // Subnormals are scaled into the normal range first
+         const auto subnormal = ratio < (Doubles{} + std::numeric_limits<double>::min());
+         const Doubles normal = subnormal ? (ratio * TWO_POW_52) : ratio;
+         Bits bits;
+         Reinterpret(bits, normal);
+
+         Doubles mantissa;
+         Doubles octaves;
+         Reinterpret(mantissa, (bits & MANTISSA_BITS) | ONE_BITS);
+         Reinterpret(octaves, (bits >> 52) | TWO_POW_52_BITS);
+         octaves = octaves - (TWO_POW_52 + 1023.0);
+         octaves = subnormal ? (octaves - 52.0) : octaves;
+         const auto upper = mantissa > (Doubles{} + SQRT2);
+         mantissa = upper ? (mantissa * 0.5) : mantissa;
+         octaves = upper ? (octaves + 1.0) : octaves;
+
+         const Doubles s = (mantissa - 1.0) / (mantissa + 1.0);
+         const Doubles s2 = s * s;
+         Doubles series;
+         if constexpr (Strict)
+         {
+            series = Doubles{} + (2.0 / 21.0);
+            series = (series * s2) + (2.0 / 19.0);
+            series = (series * s2) + (2.0 / 17.0);
+            series = (series * s2) + (2.0 / 15.0);
+            series = (series * s2) + (2.0 / 13.0);
+            series = (series * s2) + (2.0 / 11.0);
+         }
+         else
+         {
+            series = Doubles{} + (2.0 / 11.0);
+         }
+         series = (series * s2) + (2.0 / 9.0);
+         series = (series * s2) + (2.0 / 7.0);
+         series = (series * s2) + (2.0 / 5.0);
+         series = (series * s2) + (2.0 / 3.0);
+         const Doubles nepers = (s * 2.0) + ((s * s2) * series);
+
+         Doubles decibels = (octaves * DECIBELS_PER_OCTAVE_HIGH) + ((octaves * DECIBELS_PER_OCTAVE_LOW) + (nepers * DECIBELS_PER_NEPER));
+         decibels = (ratio == (Doubles{} + 0.0)) ? (Doubles{} - std::numeric_limits<double>::infinity()) : decibels;
+         decibels = (ratio == (Doubles{} + std::numeric_limits<double>::infinity())) ? ratio : decibels;
+         values = ((ratio < (Doubles{} + 0.0)) | (ratio != ratio)) ? (Doubles{} + std::numeric_limits<double>::quiet_NaN()) : decibels;
+      }
+
+      template <class Doubles, class Bits, bool Strict, bool ToRatio>
+      UNITS_LANES_INLINE void Decibels(Doubles& values, double scale)
+      {
+         if constexpr (ToRatio)
+         {
+            Exp10Decibels<Doubles, Bits, Strict>(values);
+            values = values * scale;
+         }
+         else
+         {
+            values = values * scale;
+            Log10Decibels<Doubles, Bits, Strict>(values);
+         }
+      }
+
+      // Whole vectors with unaligned loads and stores, then one value at a time
+      template <class Doubles, class Bits, bool Strict, bool ToRatio>
+      UNITS_LANES_INLINE void DecibelLanes(const double* input, double* output, std::size_t count, double scale)
+      {
+         constexpr std::size_t width = sizeof(Doubles) / sizeof(double);
+         std::size_t i = 0;
+         for (; (i + width) <= count; i += width)
+         {
+            Doubles values;
+            std::memcpy(&values, input + i, sizeof(values));
+            Decibels<Doubles, Bits, Strict, ToRatio>(values, scale);
+            std::memcpy(output + i, &values, sizeof(values));
+         }
+         for (; i < count; ++i)
+         {
+            double value = input[i];
+            Decibels<double, std::uint64_t, Strict, ToRatio>(value, scale);
+            output[i] = value;
+         }
+      }
+
+      template <bool Strict, bool ToRatio>
+      inline void DecibelScalar(const double* input, double* output, std::size_t count, double scale)
+      {
+         DecibelLanes<double, std::uint64_t, Strict, ToRatio>(input, output, count, scale);
+      }
+
+      // Binary angle sin / cos and atan2, whole vectors then one value at a time
+      template <class Doubles, class Unsigned>
+      UNITS_LANES_INLINE void PhaseSinCosLanes(const Unsigned* phases, double* sines, double* cosines, std::size_t count)
+      {
+         using Phases = typename Trigonometry::LanesOf<Unsigned, Doubles>::type;
+         constexpr std::size_t width = sizeof(Doubles) / sizeof(double);
+         std::size_t i = 0;
+         for (; (i + width) <= count; i += width)
+         {
+            Phases values;
+            std::memcpy(&values, phases + i, sizeof(values));
+            Doubles sine;
+            Doubles cosine;
+            Trigonometry::PhaseSinCos<Doubles, Phases, Unsigned>(values, sine, cosine);
+            if (sines != nullptr)
+            {
+               std::memcpy(sines + i, &sine, sizeof(sine));
+            }
+            if (cosines != nullptr)
+            {
+               std::memcpy(cosines + i, &cosine, sizeof(cosine));
+            }
+         }
+         for (; i < count; ++i)
+         {
+            double sine;
+            double cosine;
+            Trigonometry::PhaseSinCos<double, Unsigned, Unsigned>(phases[i], sine, cosine);
+            if (sines != nullptr)
+            {
+               sines[i] = sine;
+            }
+            if (cosines != nullptr)
+            {
+               cosines[i] = cosine;
+            }
+         }
+      }
+
+      template <class Doubles, class Unsigned>
+      UNITS_LANES_INLINE void PhaseAtan2Lanes(const double* y, const double* x, Unsigned* phases, std::size_t count)
+      {
+         using Phases = typename Trigonometry::LanesOf<Unsigned, Doubles>::type;
+         constexpr std::size_t width = sizeof(Doubles) / sizeof(double);
+         std::size_t i = 0;
+         for (; (i + width) <= count; i += width)
+         {
+            Doubles yValues;
+            Doubles xValues;
+            std::memcpy(&yValues, y + i, sizeof(yValues));
+            std::memcpy(&xValues, x + i, sizeof(xValues));
+            Doubles radians;
+            Phases values;
+            Trigonometry::Atan2(yValues, xValues, radians);
+            Trigonometry::RadiansToPhase<Phases, Unsigned>(radians, values);
+            std::memcpy(phases + i, &values, sizeof(values));
+         }
+         for (; i < count; ++i)
+         {
+            double radians;
+            Trigonometry::Atan2(y[i], x[i], radians);
+            Trigonometry::RadiansToPhase<Unsigned, Unsigned>(radians, phases[i]);
+         }
+      }
+
+      // Angles in degrees, the same shape as the binary angle loops
+      template <class Doubles>
+      UNITS_LANES_INLINE void DegreesSinCosLanes(const double* degrees, double* sines, double* cosines, std::size_t count)
+      {
+         constexpr std::size_t width = sizeof(Doubles) / sizeof(double);
+         std::size_t i = 0;
+         for (; (i + width) <= count; i += width)
+         {
+            Doubles values;
+            std::memcpy(&values, degrees + i, sizeof(values));
+            Doubles sine;
+            Doubles cosine;
+            Trigonometry::DegreesSinCos(values, sine, cosine);
+            if (sines != nullptr)
+            {
+               std::memcpy(sines + i, &sine, sizeof(sine));
+            }
+            if (cosines != nullptr)
+            {
+               std::memcpy(cosines + i, &cosine, sizeof(cosine));
+            }
+         }
+         for (; i < count; ++i)
+         {
+            double sine;
+            double cosine;
+            Trigonometry::DegreesSinCos(degrees[i], sine, cosine);
+            if (sines != nullptr)
+            {
+               sines[i] = sine;
+            }
+            if (cosines != nullptr)
+            {
+               cosines[i] = cosine;
+            }
+         }
+      }
+
+      template <class Doubles>
+      UNITS_LANES_INLINE void DegreesAtan2Lanes(const double* y, const double* x, double* degrees, std::size_t count)
+      {
+         constexpr double DEGREES_PER_RADIAN = 180.0 / Trigonometry::PI;
+         constexpr std::size_t width = sizeof(Doubles) / sizeof(double);
+         std::size_t i = 0;
+         for (; (i + width) <= count; i += width)
+         {
+            Doubles yValues;
+            Doubles xValues;
+            std::memcpy(&yValues, y + i, sizeof(yValues));
+            std::memcpy(&xValues, x + i, sizeof(xValues));
+            Doubles radians;
+            Trigonometry::Atan2(yValues, xValues, radians);
+            radians = radians * DEGREES_PER_RADIAN;
+            std::memcpy(degrees + i, &radians, sizeof(radians));
+         }
+         for (; i < count; ++i)
+         {
+            double radians;
+            Trigonometry::Atan2(y[i], x[i], radians);
+            degrees[i] = radians * DEGREES_PER_RADIAN;
+         }
+      }
+
+      // Sums into one accumulator per lane, added in lane order at the end
+      template <class Doubles>
+      UNITS_LANES_INLINE void DegreesSinCosSumLanes(const double* degrees, std::size_t count, double& sineSum, double& cosineSum)
+      {
+         constexpr std::size_t width = sizeof(Doubles) / sizeof(double);
+         Doubles sineLanes = Doubles{} + 0.0;
+         Doubles cosineLanes = Doubles{} + 0.0;
+         std::size_t i = 0;
+         for (; (i + width) <= count; i += width)
+         {
+            Doubles values;
+            std::memcpy(&values, degrees + i, sizeof(values));
+            Doubles sine;
+            Doubles cosine;
+            Trigonometry::DegreesSinCos(values, sine, cosine);
+            sineLanes = sineLanes + sine;
+            cosineLanes = cosineLanes + cosine;
+         }
+
+         double sineValues[width];
+         double cosineValues[width];
+         std::memcpy(sineValues, &sineLanes, sizeof(sineLanes));
+         std::memcpy(cosineValues, &cosineLanes, sizeof(cosineLanes));
+         sineSum = 0.0;
+         cosineSum = 0.0;
+         for (std::size_t lane = 0; lane < width; ++lane)
+         {
+            sineSum += sineValues[lane];
+            cosineSum += cosineValues[lane];
+         }
+         for (; i < count; ++i)
+         {
+            double sine;
+            double cosine;
+            Trigonometry::DegreesSinCos(degrees[i], sine, cosine);
+            sineSum += sine;
+            cosineSum += cosine;
+         }
+      }
+
+      template <AngleWrap Wrap>
+      inline double WrapOne(double degrees)
+      {
+         return (Wrap == AngleWrap::Positive) ? Angle::WrapPositive(degrees) : Angle::WrapSigned(degrees);
+      }
+
+      // The steps of Angle::WrapPositive / WrapSigned below 2^53 degrees. Lanes
+      // past that, infinity and NaN are passed through and wrapped one at a
+      // time after the vector pass, so wrapped can be the same memory as degrees.
+      template <class Doubles, AngleWrap Wrap>
+      UNITS_LANES_INLINE void WrapDegreesLanes(const double* degrees, double* wrapped, std::size_t count)
+      {
+         constexpr double TWO_POW_53 = 9007199254740992.0;
+         constexpr std::size_t width = sizeof(Doubles) / sizeof(double);
+         Doubles passed = Doubles{} + 0.0;
+         std::size_t i = 0;
+         for (; (i + width) <= count; i += width)
+         {
+            Doubles values;
+            std::memcpy(&values, degrees + i, sizeof(values));
+            const Doubles circles = ((values * (1.0 / 360.0)) + ROUNDING_BIAS) - ROUNDING_BIAS;
+            Doubles result = values - (circles * 360.0);
+            if constexpr (Wrap == AngleWrap::Positive)
+            {
+               result = result + ((result < 0.0) ? (Doubles{} + 360.0) : (Doubles{} + 0.0));
+               result = (result == 360.0) ? (Doubles{} + 0.0) : result;
+            }
+            else
+            {
+               result = result + ((result <= -180.0) ? (Doubles{} + 360.0) : (Doubles{} + 0.0)) - ((result > 180.0) ? (Doubles{} + 360.0) : (Doubles{} + 0.0));
+            }
+            const Doubles magnitude = (values < 0.0) ? -values : values;
+            result = (magnitude < TWO_POW_53) ? result : values;
+            passed = (magnitude < TWO_POW_53) ? passed : (Doubles{} + 1.0);
+            std::memcpy(wrapped + i, &result, sizeof(result));
+         }
+
+         double passedValues[width];
+         std::memcpy(passedValues, &passed, sizeof(passed));
+         bool anyPassed = false;
+         for (std::size_t lane = 0; lane < width; ++lane)
+         {
+            anyPassed = anyPassed || (passedValues[lane] != 0.0);
+         }
+         if (anyPassed)
+         {
+            for (std::size_t j = 0; j < i; ++j)
+            {
+               // Wrapped values are within 360, only the passed ones remain
+               if (!(std::fabs(wrapped[j]) < TWO_POW_53))
+               {
+                  wrapped[j] = WrapOne<Wrap>(wrapped[j]);
+               }
+            }
+         }
+         for (; i < count; ++i)
+         {
+            wrapped[i] = WrapOne<Wrap>(degrees[i]);
+         }
+      }
+
+      // The kick opening a Verlet step, finishing the velocity of the step
+      // before. NaN != NaN, no step before to finish.
+      template <class Values>
+      UNITS_LANES_INLINE void VerletKick(Values& velocity, const Values& acceleration, const Values& previous, double dt)
+      {
+         Values kick = (previous + acceleration) * (0.5 * dt);
+         UNITS_ROUND_PRODUCT(kick);
+         velocity = velocity + ((previous == previous) ? kick : (Values{} + 0.0));
+      }
+
+      // One step of one axis, see Integrator. Each product is rounded before
+      // it is added, so no kernel contracts them into an FMA.
+      template <Integrator Method, class Values>
+      UNITS_LANES_INLINE void MotionStep(Values& position, Values& velocity, const Values& acceleration, Values& previous, double dt)
+      {
+         if constexpr (Method == Integrator::Euler)
+         {
+            Values kick = acceleration * dt;
+            Values drift = velocity * dt;
+            UNITS_ROUND_PRODUCT(kick);
+            UNITS_ROUND_PRODUCT(drift);
+            position = position + drift;
+            velocity = velocity + kick;
+         }
+         else if constexpr (Method == Integrator::SemiImplicitEuler)
+         {
+            Values kick = acceleration * dt;
+            UNITS_ROUND_PRODUCT(kick);
+            velocity = velocity + kick;
+            Values drift = velocity * dt;
+            UNITS_ROUND_PRODUCT(drift);
+            position = position + drift;
+         }
+         else
+         {
+            VerletKick(velocity, acceleration, previous, dt);
+            Values drift = velocity * dt;
+            Values curve = acceleration * (0.5 * dt * dt);
+            UNITS_ROUND_PRODUCT(drift);
+            UNITS_ROUND_PRODUCT(curve);
+            position = (position + drift) + curve;
+            previous = acceleration;
+         }
+      }
+
+      // Positions and velocities in place, one pass over the arrays
+      template <class Doubles, Integrator Method>
+      UNITS_LANES_INLINE void MotionLanes(double* positions, double* velocities, const double* accelerations, double* previous,
+         std::size_t count, double dt)
+      {
+         constexpr bool usesPrevious = (Method == Integrator::Verlet);
+         constexpr std::size_t width = sizeof(Doubles) / sizeof(double);
+         std::size_t i = 0;
+         for (; (i + width) <= count; i += width)
+         {
+            Doubles position;
+            Doubles velocity;
+            Doubles acceleration;
+            Doubles previousAcceleration = Doubles{} + 0.0;
+            std::memcpy(&position, positions + i, sizeof(position));
+            std::memcpy(&velocity, velocities + i, sizeof(velocity));
+            std::memcpy(&acceleration, accelerations + i, sizeof(acceleration));
+            if constexpr (usesPrevious)
+            {
+               std::memcpy(&previousAcceleration, previous + i, sizeof(previousAcceleration));
+            }
+            MotionStep<Method>(position, velocity, acceleration, previousAcceleration, dt);
+            std::memcpy(positions + i, &position, sizeof(position));
+            std::memcpy(velocities + i, &velocity, sizeof(velocity));
+            if constexpr (usesPrevious)
+            {
+               std::memcpy(previous + i, &previousAcceleration, sizeof(previousAcceleration));
+            }
+         }
+         for (; i < count; ++i)
+         {
+            double previousAcceleration = usesPrevious ? previous[i] : 0.0;
+            MotionStep<Method>(positions[i], velocities[i], accelerations[i], previousAcceleration, dt);
+            if constexpr (usesPrevious)
+            {
+               previous[i] = previousAcceleration;
+            }
+         }
+      }
+
+      // The kick of the next Verlet step ahead of time, then no step before
+      // so that step does not kick again
+      template <class Doubles>
+      UNITS_LANES_INLINE void FinishLanes(double* velocities, const double* accelerations, double* previous, std::size_t count, double dt)
+      {
+         constexpr std::size_t width = sizeof(Doubles) / sizeof(double);
+         constexpr double NO_STEP = std::numeric_limits<double>::quiet_NaN();
+         std::size_t i = 0;
+         for (; (i + width) <= count; i += width)
+         {
+            Doubles velocity;
+            Doubles acceleration;
+            Doubles previousAcceleration;
+            std::memcpy(&velocity, velocities + i, sizeof(velocity));
+            std::memcpy(&acceleration, accelerations + i, sizeof(acceleration));
+            std::memcpy(&previousAcceleration, previous + i, sizeof(previousAcceleration));
+            VerletKick(velocity, acceleration, previousAcceleration, dt);
+            previousAcceleration = Doubles{} + NO_STEP;
+            std::memcpy(velocities + i, &velocity, sizeof(velocity));
+            std::memcpy(previous + i, &previousAcceleration, sizeof(previousAcceleration));
+         }
+         for (; i < count; ++i)
+         {
+            VerletKick(velocities[i], accelerations[i], previous[i], dt);
+            previous[i] = NO_STEP;
+         }
+      }
+
+      template <class Unsigned>
+      inline void PhaseSinCosScalar(const Unsigned* phases, double* sines, double* cosines, std::size_t count)
+      {
+         PhaseSinCosLanes<double>(phases, sines, cosines, count);
+      }
+      template <class Unsigned>
+      inline void PhaseAtan2Scalar(const double* y, const double* x, Unsigned* phases, std::size_t count)
+      {
+         PhaseAtan2Lanes<double>(y, x, phases, count);
+      }
+
+      inline void DegreesSinCosScalar(const double* degrees, double* sines, double* cosines, std::size_t count)
+      {
+         DegreesSinCosLanes<double>(degrees, sines, cosines, count);
+      }
+      inline void DegreesAtan2Scalar(const double* y, const double* x, double* degrees, std::size_t count)
+      {
+         DegreesAtan2Lanes<double>(y, x, degrees, count);
+      }
+      inline void DegreesSinCosSumScalar(const double* degrees, std::size_t count, double& sineSum, double& cosineSum)
+      {
+         DegreesSinCosSumLanes<double>(degrees, count, sineSum, cosineSum);
+      }
+
+      template <AngleWrap Wrap>
+      inline void WrapDegreesScalar(const double* degrees, double* wrapped, std::size_t count)
+      {
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            wrapped[i] = WrapOne<Wrap>(degrees[i]);
+         }
+      }
+
+      template <Integrator Method>
+      inline void MotionScalar(double* positions, double* velocities, const double* accelerations, double* previous,
+         std::size_t count, double dt)
+      {
+         MotionLanes<double, Method>(positions, velocities, accelerations, previous, count, dt);
+      }
+
+      inline void FinishScalar(double* velocities, const double* accelerations, double* previous, std::size_t count, double dt)
+      {
+         FinishLanes<double>(velocities, accelerations, previous, count, dt);
+      }
+
+#ifdef UNITS_BATCH_LANES
+      typedef double Doubles2 __attribute__((vector_size(16)));
+      typedef std::uint64_t Bits2 __attribute__((vector_size(16)));
+      typedef double Doubles4 __attribute__((vector_size(32)));
+      typedef std::uint64_t Bits4 __attribute__((vector_size(32)));
+      typedef double Doubles8 __attribute__((vector_size(64)));
+      typedef std::uint64_t Bits8 __attribute__((vector_size(64)));
+
+      template <bool Strict, bool ToRatio>
+      UNITS_TARGET("sse2") inline void DecibelSSE2(const double* input, double* output, std::size_t count, double scale)
+      {
+         DecibelLanes<Doubles2, Bits2, Strict, ToRatio>(input, output, count, scale);
+      }
+
+      template <bool Strict, bool ToRatio>
+      UNITS_TARGET("avx2,fma") inline void DecibelAVX2(const double* input, double* output, std::size_t count, double scale)
+      {
+         DecibelLanes<Doubles4, Bits4, Strict, ToRatio>(input, output, count, scale);
+      }
+
+      template <bool Strict, bool ToRatio>
+      UNITS_TARGET("avx512f") inline void DecibelAVX512(const double* input, double* output, std::size_t count, double scale)
+      {
+         DecibelLanes<Doubles8, Bits8, Strict, ToRatio>(input, output, count, scale);
+      }
+
+      template <class Unsigned>
+      UNITS_TARGET("sse2") inline void PhaseSinCosSSE2(const Unsigned* phases, double* sines, double* cosines, std::size_t count)
+      {
+         PhaseSinCosLanes<Doubles2>(phases, sines, cosines, count);
+      }
+      template <class Unsigned>
+      UNITS_TARGET("avx2,fma") inline void PhaseSinCosAVX2(const Unsigned* phases, double* sines, double* cosines, std::size_t count)
+      {
+         PhaseSinCosLanes<Doubles4>(phases, sines, cosines, count);
+      }
+      template <class Unsigned>
+      UNITS_TARGET("avx512f") inline void PhaseSinCosAVX512(const Unsigned* phases, double* sines, double* cosines, std::size_t count)
+      {
+         PhaseSinCosLanes<Doubles8>(phases, sines, cosines, count);
+      }
+
+      template <class Unsigned>
+      UNITS_TARGET("sse2") inline void PhaseAtan2SSE2(const double* y, const double* x, Unsigned* phases, std::size_t count)
+      {
+         PhaseAtan2Lanes<Doubles2>(y, x, phases, count);
+      }
+      template <class Unsigned>
+      UNITS_TARGET("avx2,fma") inline void PhaseAtan2AVX2(const double* y, const double* x, Unsigned* phases, std::size_t count)
+      {
+         PhaseAtan2Lanes<Doubles4>(y, x, phases, count);
+      }
+      template <class Unsigned>
+      UNITS_TARGET("avx512f") inline void PhaseAtan2AVX512(const double* y, const double* x, Unsigned* phases, std::size_t count)
+      {
+         PhaseAtan2Lanes<Doubles8>(y, x, phases, count);
+      }
+
+      UNITS_TARGET("sse2") inline void DegreesSinCosSSE2(const double* degrees, double* sines, double* cosines, std::size_t count)
+      {
+         DegreesSinCosLanes<Doubles2>(degrees, sines, cosines, count);
+      }
+      UNITS_TARGET("sse2") inline void DegreesAtan2SSE2(const double* y, const double* x, double* degrees, std::size_t count)
+      {
+         DegreesAtan2Lanes<Doubles2>(y, x, degrees, count);
+      }
+      UNITS_TARGET("sse2") inline void DegreesSinCosSumSSE2(const double* degrees, std::size_t count, double& sineSum, double& cosineSum)
+      {
+         DegreesSinCosSumLanes<Doubles2>(degrees, count, sineSum, cosineSum);
+      }
+
+      UNITS_TARGET("avx2,fma") inline void DegreesSinCosAVX2(const double* degrees, double* sines, double* cosines, std::size_t count)
+      {
+         DegreesSinCosLanes<Doubles4>(degrees, sines, cosines, count);
+      }
+      UNITS_TARGET("avx2,fma") inline void DegreesAtan2AVX2(const double* y, const double* x, double* degrees, std::size_t count)
+      {
+         DegreesAtan2Lanes<Doubles4>(y, x, degrees, count);
+      }
+      UNITS_TARGET("avx2,fma") inline void DegreesSinCosSumAVX2(const double* degrees, std::size_t count, double& sineSum, double& cosineSum)
+      {
+         DegreesSinCosSumLanes<Doubles4>(degrees, count, sineSum, cosineSum);
+      }
+
+      UNITS_TARGET("avx512f") inline void DegreesSinCosAVX512(const double* degrees, double* sines, double* cosines, std::size_t count)
+      {
+         DegreesSinCosLanes<Doubles8>(degrees, sines, cosines, count);
+      }
+      UNITS_TARGET("avx512f") inline void DegreesAtan2AVX512(const double* y, const double* x, double* degrees, std::size_t count)
+      {
+         DegreesAtan2Lanes<Doubles8>(y, x, degrees, count);
+      }
+      UNITS_TARGET("avx512f") inline void DegreesSinCosSumAVX512(const double* degrees, std::size_t count, double& sineSum, double& cosineSum)
+      {
+         DegreesSinCosSumLanes<Doubles8>(degrees, count, sineSum, cosineSum);
+      }
+
+      template <AngleWrap Wrap>
+      UNITS_TARGET("sse2") inline void WrapDegreesSSE2(const double* degrees, double* wrapped, std::size_t count)
+      {
+         WrapDegreesLanes<Doubles2, Wrap>(degrees, wrapped, count);
+      }
+      template <AngleWrap Wrap>
+      UNITS_TARGET("avx2") inline void WrapDegreesAVX2(const double* degrees, double* wrapped, std::size_t count)
+      {
+         WrapDegreesLanes<Doubles4, Wrap>(degrees, wrapped, count);
+      }
+      template <AngleWrap Wrap>
+      UNITS_TARGET("avx512f") inline void WrapDegreesAVX512(const double* degrees, double* wrapped, std::size_t count)
+      {
+         WrapDegreesLanes<Doubles8, Wrap>(degrees, wrapped, count);
+      }
+
+      template <Integrator Method>
+      UNITS_TARGET("sse2") inline void MotionSSE2(double* positions, double* velocities, const double* accelerations, double* previous,
+         std::size_t count, double dt)
+      {
+         MotionLanes<Doubles2, Method>(positions, velocities, accelerations, previous, count, dt);
+      }
+      template <Integrator Method>
+      UNITS_TARGET("avx2") inline void MotionAVX2(double* positions, double* velocities, const double* accelerations, double* previous,
+         std::size_t count, double dt)
+      {
+         MotionLanes<Doubles4, Method>(positions, velocities, accelerations, previous, count, dt);
+      }
+      template <Integrator Method>
+      UNITS_TARGET("avx512f") inline void MotionAVX512(double* positions, double* velocities, const double* accelerations, double* previous,
+         std::size_t count, double dt)
+      {
+         MotionLanes<Doubles8, Method>(positions, velocities, accelerations, previous, count, dt);
+      }
+
+      UNITS_TARGET("sse2") inline void FinishSSE2(double* velocities, const double* accelerations, double* previous, std::size_t count, double dt)
+      {
+         FinishLanes<Doubles2>(velocities, accelerations, previous, count, dt);
+      }
+      UNITS_TARGET("avx2") inline void FinishAVX2(double* velocities, const double* accelerations, double* previous, std::size_t count, double dt)
+      {
+         FinishLanes<Doubles4>(velocities, accelerations, previous, count, dt);
+      }
+      UNITS_TARGET("avx512f") inline void FinishAVX512(double* velocities, const double* accelerations, double* previous, std::size_t count, double dt)
+      {
+         FinishLanes<Doubles8>(velocities, accelerations, previous, count, dt);
+      }
+#endif
+
+      inline BatchKernel Detect()
+      {
+#if defined(UNITS_BATCH_X86) && defined(_MSC_VER)
+         int registers[4];
+         __cpuid(registers, 1);
+         const bool sse2 = (registers[3] & (1 << 26)) != 0;
+         const bool fma = (registers[2] & (1 << 12)) != 0;
+         const bool osxsave = (registers[2] & (1 << 27)) != 0;
+         // The OS must save the YMM / ZMM registers for AVX to be usable
+         const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+         const bool ymmEnabled = (xcr0 & 0x06) == 0x06;
+         const bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+
+         __cpuidex(registers, 7, 0);
+         if (zmmEnabled && ((registers[1] & (1 << 16)) != 0))
+         {
+            return BatchKernel::AVX512;
+         }
+         if (ymmEnabled && fma && ((registers[1] & (1 << 5)) != 0))
+         {
+            return BatchKernel::AVX2;
+         }
+         if (sse2)
+         {
+            return BatchKernel::SSE2;
+         }
+#elif defined(UNITS_BATCH_X86)
+         __builtin_cpu_init();
+         if (__builtin_cpu_supports("avx512f"))
+         {
+            return BatchKernel::AVX512;
+         }
+         if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+         {
+            return BatchKernel::AVX2;
+         }
+         if (__builtin_cpu_supports("sse2"))
+         {
+            return BatchKernel::SSE2;
+         }
+#endif
+         return BatchKernel::Scalar;
+      }
+
+      template <bool Affine, class Value>
+      inline void Run(BatchKernel kernel, const Value* input, Value* output, std::size_t count, Value factor, Value offset)
+      {
+         switch (kernel)
+         {
+#ifdef UNITS_BATCH_X86
+         case BatchKernel::AVX512:
+            AVX512<Affine>(input, output, count, factor, offset);
+            break;
+         case BatchKernel::AVX2:
+            AVX2<Affine>(input, output, count, factor, offset);
+            break;
+         case BatchKernel::SSE2:
+            SSE2<Affine>(input, output, count, factor, offset);
+            break;
+#endif
+         default:
+            Scalar<Affine>(input, output, count, factor, offset);
+            break;
+         }
+      }
+
+      template <class Value>
+      inline void RunScaleOffset(std::span<const Value> input, std::span<Value> output, Value factor, Value offset, BatchKernel kernel)
+      {
+         if (output.size() < input.size())
+         {
+            throw std::invalid_argument("Units::ScaleOffset output is smaller than input");
+         }
+         if (kernel > SupportedBatchKernel())
+         {
+            throw std::invalid_argument("Units::ScaleOffset kernel is not supported by this CPU");
+         }
+
+         if (offset == Value(0))
+         {
+            Run<false>(kernel, input.data(), output.data(), input.size(), factor, offset);
+         }
+         else
+         {
+            Run<true>(kernel, input.data(), output.data(), input.size(), factor, offset);
+         }
+      }
+
+      template <bool Strict, bool ToRatio>
+      inline void RunDecibels(BatchKernel kernel, const double* input, double* output, std::size_t count, double scale)
+      {
+         switch (kernel)
+         {
+#ifdef UNITS_BATCH_LANES
+         case BatchKernel::AVX512:
+            DecibelAVX512<Strict, ToRatio>(input, output, count, scale);
+            break;
+         case BatchKernel::AVX2:
+            DecibelAVX2<Strict, ToRatio>(input, output, count, scale);
+            break;
+         case BatchKernel::SSE2:
+            DecibelSSE2<Strict, ToRatio>(input, output, count, scale);
+            break;
+#endif
+         default:
+            DecibelScalar<Strict, ToRatio>(input, output, count, scale);
+            break;
+         }
+      }
+
+      template <bool ToRatio>
+      inline void RunDecibels(std::span<const double> input, std::span<double> output, double scale, BatchPrecision precision, BatchKernel kernel)
+      {
+         if (output.size() < input.size())
+         {
+            throw std::invalid_argument(ToRatio ? "Units::DecibelsToRatio output is smaller than input" : "Units::RatioToDecibels output is smaller than input");
+         }
+         if (kernel > SupportedBatchKernel())
+         {
+            throw std::invalid_argument(ToRatio ? "Units::DecibelsToRatio kernel is not supported by this CPU" : "Units::RatioToDecibels kernel is not supported by this CPU");
+         }
+
+         if (precision == BatchPrecision::Strict)
+         {
+            RunDecibels<true, ToRatio>(kernel, input.data(), output.data(), input.size(), scale);
+         }
+         else
+         {
+            RunDecibels<false, ToRatio>(kernel, input.data(), output.data(), input.size(), scale);
+         }
+      }
+
+      template <class Unsigned>
+      inline void RunPhaseSinCos(std::span<const Unsigned> phases, std::span<double> sines, std::span<double> cosines, BatchKernel kernel)
+      {
+         if ((!sines.empty() && (sines.size() < phases.size())) || (!cosines.empty() && (cosines.size() < phases.size())))
+         {
+            throw std::invalid_argument("Units::PhaseSinCos output is smaller than input");
+         }
+         if (kernel > SupportedBatchKernel())
+         {
+            throw std::invalid_argument("Units::PhaseSinCos kernel is not supported by this CPU");
+         }
+
+         const Unsigned* input = phases.data();
+         double* const sineOutput = sines.empty() ? nullptr : sines.data();
+         double* const cosineOutput = cosines.empty() ? nullptr : cosines.data();
+         const std::size_t count = phases.size();
+         switch (kernel)
+         {
+#ifdef UNITS_BATCH_LANES
+         case BatchKernel::AVX512:
+            PhaseSinCosAVX512(input, sineOutput, cosineOutput, count);
+            break;
+         case BatchKernel::AVX2:
+            PhaseSinCosAVX2(input, sineOutput, cosineOutput, count);
+            break;
+         case BatchKernel::SSE2:
+            PhaseSinCosSSE2(input, sineOutput, cosineOutput, count);
+            break;
+#endif
+         default:
+            PhaseSinCosScalar(input, sineOutput, cosineOutput, count);
+            break;
+         }
+      }
+
+      template <class Unsigned>
+      inline void RunPhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<Unsigned> phases, BatchKernel kernel)
+      {
+         if (x.size() != y.size())
+         {
+            throw std::invalid_argument("Units::PhaseAtan2 y and x differ in size");
+         }
+         if (phases.size() < y.size())
+         {
+            throw std::invalid_argument("Units::PhaseAtan2 output is smaller than input");
+         }
+         if (kernel > SupportedBatchKernel())
+         {
+            throw std::invalid_argument("Units::PhaseAtan2 kernel is not supported by this CPU");
+         }
+
+         switch (kernel)
+         {
+#ifdef UNITS_BATCH_LANES
+         case BatchKernel::AVX512:
+            PhaseAtan2AVX512(y.data(), x.data(), phases.data(), y.size());
+            break;
+         case BatchKernel::AVX2:
+            PhaseAtan2AVX2(y.data(), x.data(), phases.data(), y.size());
+            break;
+         case BatchKernel::SSE2:
+            PhaseAtan2SSE2(y.data(), x.data(), phases.data(), y.size());
+            break;
+#endif
+         default:
+            PhaseAtan2Scalar(y.data(), x.data(), phases.data(), y.size());
+            break;
+         }
+      }
+
+      inline void RunDegreesSinCos(std::span<const double> degrees, std::span<double> sines, std::span<double> cosines, BatchKernel kernel)
+      {
+         if ((!sines.empty() && (sines.size() < degrees.size())) || (!cosines.empty() && (cosines.size() < degrees.size())))
+         {
+            throw std::invalid_argument("Units::DegreesSinCos output is smaller than input");
+         }
+         if (kernel > SupportedBatchKernel())
+         {
+            throw std::invalid_argument("Units::DegreesSinCos kernel is not supported by this CPU");
+         }
+
+         double* const sineOutput = sines.empty() ? nullptr : sines.data();
+         double* const cosineOutput = cosines.empty() ? nullptr : cosines.data();
+         switch (kernel)
+         {
+#ifdef UNITS_BATCH_LANES
+         case BatchKernel::AVX512:
+            DegreesSinCosAVX512(degrees.data(), sineOutput, cosineOutput, degrees.size());
+            break;
+         case BatchKernel::AVX2:
+            DegreesSinCosAVX2(degrees.data(), sineOutput, cosineOutput, degrees.size());
+            break;
+         case BatchKernel::SSE2:
+            DegreesSinCosSSE2(degrees.data(), sineOutput, cosineOutput, degrees.size());
+            break;
+#endif
+         default:
+            DegreesSinCosScalar(degrees.data(), sineOutput, cosineOutput, degrees.size());
+            break;
+         }
+      }
+
+      inline void RunDegreesAtan2(std::span<const double> y, std::span<const double> x, std::span<double> degrees, BatchKernel kernel)
+      {
+         if (y.size() != x.size())
+         {
+            throw std::invalid_argument("Units::DegreesAtan2 y and x differ in size");
+         }
+         if (degrees.size() < y.size())
+         {
+            throw std::invalid_argument("Units::DegreesAtan2 output is smaller than input");
+         }
+         if (kernel > SupportedBatchKernel())
+         {
+            throw std::invalid_argument("Units::DegreesAtan2 kernel is not supported by this CPU");
+         }
+
+         switch (kernel)
+         {
+#ifdef UNITS_BATCH_LANES
+         case BatchKernel::AVX512:
+            DegreesAtan2AVX512(y.data(), x.data(), degrees.data(), y.size());
+            break;
+         case BatchKernel::AVX2:
+            DegreesAtan2AVX2(y.data(), x.data(), degrees.data(), y.size());
+            break;
+         case BatchKernel::SSE2:
+            DegreesAtan2SSE2(y.data(), x.data(), degrees.data(), y.size());
+            break;
+#endif
+         default:
+            DegreesAtan2Scalar(y.data(), x.data(), degrees.data(), y.size());
+            break;
+         }
+      }
+
+      inline void RunDegreesSinCosSums(std::span<const double> degrees, double& sineSum, double& cosineSum, BatchKernel kernel)
+      {
+         if (kernel > SupportedBatchKernel())
+         {
+            throw std::invalid_argument("Units::DegreesSinCosSums kernel is not supported by this CPU");
+         }
+
+         switch (kernel)
+         {
+#ifdef UNITS_BATCH_LANES
+         case BatchKernel::AVX512:
+            DegreesSinCosSumAVX512(degrees.data(), degrees.size(), sineSum, cosineSum);
+            break;
+         case BatchKernel::AVX2:
+            DegreesSinCosSumAVX2(degrees.data(), degrees.size(), sineSum, cosineSum);
+            break;
+         case BatchKernel::SSE2:
+            DegreesSinCosSumSSE2(degrees.data(), degrees.size(), sineSum, cosineSum);
+            break;
+#endif
+         default:
+            DegreesSinCosSumScalar(degrees.data(), degrees.size(), sineSum, cosineSum);
+            break;
+         }
+      }
+
+      template <AngleWrap Wrap>
+      inline void RunWrapDegrees(BatchKernel kernel, const double* degrees, double* wrapped, std::size_t count)
+      {
+         switch (kernel)
+         {
+#ifdef UNITS_BATCH_LANES
+         case BatchKernel::AVX512:
+            WrapDegreesAVX512<Wrap>(degrees, wrapped, count);
+            break;
+         case BatchKernel::AVX2:
+            WrapDegreesAVX2<Wrap>(degrees, wrapped, count);
+            break;
+         case BatchKernel::SSE2:
+            WrapDegreesSSE2<Wrap>(degrees, wrapped, count);
+            break;
+#endif
+         default:
+            WrapDegreesScalar<Wrap>(degrees, wrapped, count);
+            break;
+         }
+      }
+
+      inline void RunWrapDegrees(std::span<const double> degrees, std::span<double> wrapped, AngleWrap wrap, BatchKernel kernel)
+      {
+         if (wrapped.size() < degrees.size())
+         {
+            throw std::invalid_argument("Units::WrapDegrees output is smaller than input");
+         }
+         if (kernel > SupportedBatchKernel())
+         {
+            throw std::invalid_argument("Units::WrapDegrees kernel is not supported by this CPU");
+         }
+
+         switch (wrap)
+         {
+         case AngleWrap::Positive:
+            RunWrapDegrees<AngleWrap::Positive>(kernel, degrees.data(), wrapped.data(), degrees.size());
+            break;
+         case AngleWrap::Signed:
+            RunWrapDegrees<AngleWrap::Signed>(kernel, degrees.data(), wrapped.data(), degrees.size());
+            break;
+         default:
+            throw std::invalid_argument("Units::WrapDegrees unknown wrap");
+         }
+      }
+
+      inline void RunNorms(std::span<const double> x, std::span<const double> y, std::span<const double> z, std::span<double> norms, BatchKernel kernel)
+      {
+         if ((y.size() != x.size()) || (z.size() != x.size()))
+         {
+            throw std::invalid_argument("Units::VectorNorms components differ in size");
+         }
+         if (norms.size() < x.size())
+         {
+            throw std::invalid_argument("Units::VectorNorms output is smaller than input");
+         }
+         if (kernel > SupportedBatchKernel())
+         {
+            throw std::invalid_argument("Units::VectorNorms kernel is not supported by this CPU");
+         }
+
+         switch (kernel)
+         {
+#ifdef UNITS_BATCH_X86
+         case BatchKernel::AVX512:
+            NormAVX512(x.data(), y.data(), z.data(), norms.data(), x.size());
+            break;
+         case BatchKernel::AVX2:
+            NormAVX2(x.data(), y.data(), z.data(), norms.data(), x.size());
+            break;
+         case BatchKernel::SSE2:
+            NormSSE2(x.data(), y.data(), z.data(), norms.data(), x.size());
+            break;
+#endif
+         default:
+            NormScalar(x.data(), y.data(), z.data(), norms.data(), x.size());
+            break;
+         }
+      }
+
+      template <Integrator Method>
+      inline void RunMotion(BatchKernel kernel, double* positions, double* velocities, const double* accelerations, double* previous,
+         std::size_t count, double dt)
+      {
+         switch (kernel)
+         {
+#ifdef UNITS_BATCH_LANES
+         case BatchKernel::AVX512:
+            MotionAVX512<Method>(positions, velocities, accelerations, previous, count, dt);
+            break;
+         case BatchKernel::AVX2:
+            MotionAVX2<Method>(positions, velocities, accelerations, previous, count, dt);
+            break;
+         case BatchKernel::SSE2:
+            MotionSSE2<Method>(positions, velocities, accelerations, previous, count, dt);
+            break;
+#endif
+         default:
+            MotionScalar<Method>(positions, velocities, accelerations, previous, count, dt);
+            break;
+         }
+      }
+
+      inline void RunMotion(std::span<double> positions, std::span<double> velocities, std::span<const double> accelerations,
+         std::span<double> previousAccelerations, double dt, Integrator integrator, BatchKernel kernel)
+      {
+         if ((velocities.size() != positions.size()) || (accelerations.size() != positions.size()))
+         {
+            throw std::invalid_argument("Units::IntegrateMotion positions, velocities and accelerations differ in size");
+         }
+         if ((integrator == Integrator::Verlet) && (previousAccelerations.size() != positions.size()))
+         {
+            throw std::invalid_argument("Units::IntegrateMotion previous accelerations differ in size");
+         }
+         if (kernel > SupportedBatchKernel())
+         {
+            throw std::invalid_argument("Units::IntegrateMotion kernel is not supported by this CPU");
+         }
+
+         switch (integrator)
+         {
+         case Integrator::Euler:
+            RunMotion<Integrator::Euler>(kernel, positions.data(), velocities.data(), accelerations.data(), nullptr, positions.size(), dt);
+            break;
+         case Integrator::SemiImplicitEuler:
+            RunMotion<Integrator::SemiImplicitEuler>(kernel, positions.data(), velocities.data(), accelerations.data(), nullptr, positions.size(), dt);
+            break;
+         case Integrator::Verlet:
+            RunMotion<Integrator::Verlet>(kernel, positions.data(), velocities.data(), accelerations.data(), previousAccelerations.data(),
+               positions.size(), dt);
+            break;
+         default:
+            throw std::invalid_argument("Units::IntegrateMotion unknown integrator");
+         }
+      }
+
+      inline void RunFinish(std::span<double> velocities, std::span<const double> accelerations, std::span<double> previousAccelerations,
+         double dt, BatchKernel kernel)
+      {
+         if ((accelerations.size() != velocities.size()) || (previousAccelerations.size() != velocities.size()))
+         {
+            throw std::invalid_argument("Units::FinishVerlet velocities and accelerations differ in size");
+         }
+         if (kernel > SupportedBatchKernel())
+         {
+            throw std::invalid_argument("Units::FinishVerlet kernel is not supported by this CPU");
+         }
+
+         switch (kernel)
+         {
+#ifdef UNITS_BATCH_LANES
+         case BatchKernel::AVX512:
+            FinishAVX512(velocities.data(), accelerations.data(), previousAccelerations.data(), velocities.size(), dt);
+            break;
+         case BatchKernel::AVX2:
+            FinishAVX2(velocities.data(), accelerations.data(), previousAccelerations.data(), velocities.size(), dt);
+            break;
+         case BatchKernel::SSE2:
+            FinishSSE2(velocities.data(), accelerations.data(), previousAccelerations.data(), velocities.size(), dt);
+            break;
+#endif
+         default:
+            FinishScalar(velocities.data(), accelerations.data(), previousAccelerations.data(), velocities.size(), dt);
+            break;
+         }
+      }
+   } //end namespace BatchKernels
+
+   UNITS_INLINE BatchKernel SupportedBatchKernel()
+   {
+      static const BatchKernel supported = BatchKernels::Detect();
+      return supported;
+   }
+
+   UNITS_INLINE void ScaleOffset(std::span<const double> input, std::span<double> output, double factor, double offset)
+   {
+      ScaleOffset(input, output, factor, offset, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void ScaleOffset(std::span<const double> input, std::span<double> output, double factor, double offset, BatchKernel kernel)
+   {
+      BatchKernels::RunScaleOffset(input, output, factor, offset, kernel);
+   }
+
+   UNITS_INLINE void ScaleOffset(std::span<const float> input, std::span<float> output, float factor, float offset)
+   {
+      BatchKernels::RunScaleOffset(input, output, factor, offset, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void ScaleOffset(std::span<const float> input, std::span<float> output, float factor, float offset, BatchKernel kernel)
+   {
+      BatchKernels::RunScaleOffset(input, output, factor, offset, kernel);
+   }
+
+   UNITS_INLINE void DecibelsToRatio(std::span<const double> input, std::span<double> output, double scale, BatchPrecision precision)
+   {
+      BatchKernels::RunDecibels<true>(input, output, scale, precision, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void DecibelsToRatio(std::span<const double> input, std::span<double> output, double scale, BatchPrecision precision, BatchKernel kernel)
+   {
+      BatchKernels::RunDecibels<true>(input, output, scale, precision, kernel);
+   }
+
+   UNITS_INLINE void RatioToDecibels(std::span<const double> input, std::span<double> output, double scale, BatchPrecision precision)
+   {
+      BatchKernels::RunDecibels<false>(input, output, scale, precision, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void RatioToDecibels(std::span<const double> input, std::span<double> output, double scale, BatchPrecision precision, BatchKernel kernel)
+   {
+      BatchKernels::RunDecibels<false>(input, output, scale, precision, kernel);
+   }
+
+   UNITS_INLINE void PhaseSinCos(std::span<const std::uint16_t> phases, std::span<double> sines, std::span<double> cosines)
+   {
+      BatchKernels::RunPhaseSinCos(phases, sines, cosines, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void PhaseSinCos(std::span<const std::uint32_t> phases, std::span<double> sines, std::span<double> cosines)
+   {
+      BatchKernels::RunPhaseSinCos(phases, sines, cosines, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void PhaseSinCos(std::span<const std::uint64_t> phases, std::span<double> sines, std::span<double> cosines)
+   {
+      BatchKernels::RunPhaseSinCos(phases, sines, cosines, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void PhaseSinCos(std::span<const std::uint16_t> phases, std::span<double> sines, std::span<double> cosines, BatchKernel kernel)
+   {
+      BatchKernels::RunPhaseSinCos(phases, sines, cosines, kernel);
+   }
+
+   UNITS_INLINE void PhaseSinCos(std::span<const std::uint32_t> phases, std::span<double> sines, std::span<double> cosines, BatchKernel kernel)
+   {
+      BatchKernels::RunPhaseSinCos(phases, sines, cosines, kernel);
+   }
+
+   UNITS_INLINE void PhaseSinCos(std::span<const std::uint64_t> phases, std::span<double> sines, std::span<double> cosines, BatchKernel kernel)
+   {
+      BatchKernels::RunPhaseSinCos(phases, sines, cosines, kernel);
+   }
+
+   UNITS_INLINE void PhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<std::uint16_t> phases)
+   {
+      BatchKernels::RunPhaseAtan2(y, x, phases, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void PhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<std::uint32_t> phases)
+   {
+      BatchKernels::RunPhaseAtan2(y, x, phases, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void PhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<std::uint64_t> phases)
+   {
+      BatchKernels::RunPhaseAtan2(y, x, phases, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void PhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<std::uint16_t> phases, BatchKernel kernel)
+   {
+      BatchKernels::RunPhaseAtan2(y, x, phases, kernel);
+   }
+
+   UNITS_INLINE void PhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<std::uint32_t> phases, BatchKernel kernel)
+   {
+      BatchKernels::RunPhaseAtan2(y, x, phases, kernel);
+   }
+
+   UNITS_INLINE void PhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<std::uint64_t> phases, BatchKernel kernel)
+   {
+      BatchKernels::RunPhaseAtan2(y, x, phases, kernel);
+   }
+
+   UNITS_INLINE void DegreesSinCos(std::span<const double> degrees, std::span<double> sines, std::span<double> cosines)
+   {
+      BatchKernels::RunDegreesSinCos(degrees, sines, cosines, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void DegreesSinCos(std::span<const double> degrees, std::span<double> sines, std::span<double> cosines, BatchKernel kernel)
+   {
+      BatchKernels::RunDegreesSinCos(degrees, sines, cosines, kernel);
+   }
+
+   UNITS_INLINE void DegreesAtan2(std::span<const double> y, std::span<const double> x, std::span<double> degrees)
+   {
+      BatchKernels::RunDegreesAtan2(y, x, degrees, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void DegreesAtan2(std::span<const double> y, std::span<const double> x, std::span<double> degrees, BatchKernel kernel)
+   {
+      BatchKernels::RunDegreesAtan2(y, x, degrees, kernel);
+   }
+
+   UNITS_INLINE void DegreesSinCosSums(std::span<const double> degrees, double& sineSum, double& cosineSum)
+   {
+      BatchKernels::RunDegreesSinCosSums(degrees, sineSum, cosineSum, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void DegreesSinCosSums(std::span<const double> degrees, double& sineSum, double& cosineSum, BatchKernel kernel)
+   {
+      BatchKernels::RunDegreesSinCosSums(degrees, sineSum, cosineSum, kernel);
+   }
+
+   UNITS_INLINE void WrapDegrees(std::span<const double> degrees, std::span<double> wrapped, AngleWrap wrap)
+   {
+      BatchKernels::RunWrapDegrees(degrees, wrapped, wrap, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void WrapDegrees(std::span<const double> degrees, std::span<double> wrapped, AngleWrap wrap, BatchKernel kernel)
+   {
+      BatchKernels::RunWrapDegrees(degrees, wrapped, wrap, kernel);
+   }
+
+   UNITS_INLINE void VectorNorms(std::span<const double> x, std::span<const double> y, std::span<const double> z, std::span<double> norms)
+   {
+      BatchKernels::RunNorms(x, y, z, norms, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void VectorNorms(std::span<const double> x, std::span<const double> y, std::span<const double> z, std::span<double> norms, BatchKernel kernel)
+   {
+      BatchKernels::RunNorms(x, y, z, norms, kernel);
+   }
+
+   UNITS_INLINE void IntegrateMotion(std::span<double> positions, std::span<double> velocities, std::span<const double> accelerations,
+      std::span<double> previousAccelerations, double dt, Integrator integrator)
+   {
+      BatchKernels::RunMotion(positions, velocities, accelerations, previousAccelerations, dt, integrator, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void IntegrateMotion(std::span<double> positions, std::span<double> velocities, std::span<const double> accelerations,
+      std::span<double> previousAccelerations, double dt, Integrator integrator, BatchKernel kernel)
+   {
+      BatchKernels::RunMotion(positions, velocities, accelerations, previousAccelerations, dt, integrator, kernel);
+   }
+
+   UNITS_INLINE void FinishVerlet(std::span<double> velocities, std::span<const double> accelerations, std::span<double> previousAccelerations,
+      double dt)
+   {
+      BatchKernels::RunFinish(velocities, accelerations, previousAccelerations, dt, SupportedBatchKernel());
+   }
+
+   UNITS_INLINE void FinishVerlet(std::span<double> velocities, std::span<const double> accelerations, std::span<double> previousAccelerations,
+      double dt, BatchKernel kernel)
+   {
+      BatchKernels::RunFinish(velocities, accelerations, previousAccelerations, dt, kernel);
+   }
+} //end namespace Units
+
+#endif  // UNITBATCH_CPP_GUARD
@@ -0,0 +1,195 @@
+#ifndef UNITBATCH_H_GUARD
+#define UNITBATCH_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include <cstdint>
+#include <span>
+
+namespace Units
+{
+   // Instruction sets the batch kernels are built for, in order of width
+   enum class BatchKernel
+   {
+      Scalar,
+      SSE2,
+      AVX2,
+      AVX512
+   };
+
+   // Widest kernel the running CPU and OS support, detected once with CPUID.
+   // AVX2 also needs FMA, which the AVX2 logarithmic and trigonometric
+   // kernels are built with (AVX-512F has FMA of its own).
+   UNITS_INLINE BatchKernel SupportedBatchKernel();
+
+   // output[i] = (input[i] * factor) + offset
+   // Every kernel rounds after the multiply and skips the add when offset is
+   // zero, so all kernels produce the same bits as the Scalar kernel and as
+   // Units::Conversion::Apply (unless the caller is built to contract a
+   // multiply and add into an FMA). output may be the same memory as input and
+   // neither needs any alignment, unaligned heads and tails are handled one
+   // value at a time.
+   UNITS_INLINE void ScaleOffset(std::span<const double> input, std::span<double> output, double factor, double offset);
+
+   // As above on a specific kernel, used to compare kernels against Scalar.
+   // Throws std::invalid_argument if the CPU does not support the kernel.
+   UNITS_INLINE void ScaleOffset(std::span<const double> input, std::span<double> output, double factor, double offset, BatchKernel kernel);
+
+   // Single precision, each kernel handles twice as many values per vector.
+   // Bit identical across kernels the same way as the double version.
+   UNITS_INLINE void ScaleOffset(std::span<const float> input, std::span<float> output, float factor, float offset);
+   UNITS_INLINE void ScaleOffset(std::span<const float> input, std::span<float> output, float factor, float offset, BatchKernel kernel);
+
+   // Accuracy of the logarithmic kernels below, measured against a long
+   // double reference with scale = 1
+   //    Strict  DecibelsToRatio within 1.5 ULP, RatioToDecibels within 3 ULP.
+   //            std::pow(10, x / 10) rounds x / 10 first and is off by up to
+   //            60 ULP at 400 dB.
+   //    Fast    DecibelsToRatio within 1e-8 relative, RatioToDecibels within
+   //            1e-10 dB. DecibelsToRatio runs at about 1.2 times the
+   //            throughput of Strict, RatioToDecibels at about the same, as
+   //            its divide dominates (unitbench --filter decibel/)
+   // Kernels with FMA (AVX2, AVX512) round less and may differ from Scalar and
+   // SSE2 in the last bit.
+   enum class BatchPrecision
+   {
+      Strict,
+      Fast
+   };
+
+   // output[i] = scale * 10^(input[i] / 10), power decibels to a linear ratio.
+   // output may be the same memory as input.
+   UNITS_INLINE void DecibelsToRatio(std::span<const double> input, std::span<double> output, double scale,
+      BatchPrecision precision = BatchPrecision::Strict);
+   UNITS_INLINE void DecibelsToRatio(std::span<const double> input, std::span<double> output, double scale,
+      BatchPrecision precision, BatchKernel kernel);
+
+   // output[i] = 10 * log10(input[i] * scale), a linear power ratio to
+   // decibels. Zero gives -infinity and negative input gives NaN.
+   UNITS_INLINE void RatioToDecibels(std::span<const double> input, std::span<double> output, double scale,
+      BatchPrecision precision = BatchPrecision::Strict);
+   UNITS_INLINE void RatioToDecibels(std::span<const double> input, std::span<double> output, double scale,
+      BatchPrecision precision, BatchKernel kernel);
+
+   // sin and cos of N bit binary angles, phase / 2^N of a full circle (see
+   // BinaryAngle.h), within 2 ULP (3 for 64 bit phases). Either output may
+   // be empty when it is not wanted. Kernels with FMA (AVX2, AVX512) may
+   // differ from Scalar and SSE2 in the last bit.
+   UNITS_INLINE void PhaseSinCos(std::span<const std::uint16_t> phases, std::span<double> sines, std::span<double> cosines);
+   UNITS_INLINE void PhaseSinCos(std::span<const std::uint32_t> phases, std::span<double> sines, std::span<double> cosines);
+   UNITS_INLINE void PhaseSinCos(std::span<const std::uint64_t> phases, std::span<double> sines, std::span<double> cosines);
+   UNITS_INLINE void PhaseSinCos(std::span<const std::uint16_t> phases, std::span<double> sines, std::span<double> cosines, BatchKernel kernel);
+   UNITS_INLINE void PhaseSinCos(std::span<const std::uint32_t> phases, std::span<double> sines, std::span<double> cosines, BatchKernel kernel);
+   UNITS_INLINE void PhaseSinCos(std::span<const std::uint64_t> phases, std::span<double> sines, std::span<double> cosines, BatchKernel kernel);
+
+   // phases[i] = the N bit phase nearest atan2(y[i], x[i]), (0, 0) and NaN
+   // give 0
+   UNITS_INLINE void PhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<std::uint16_t> phases);
+   UNITS_INLINE void PhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<std::uint32_t> phases);
+   UNITS_INLINE void PhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<std::uint64_t> phases);
+   UNITS_INLINE void PhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<std::uint16_t> phases, BatchKernel kernel);
+   UNITS_INLINE void PhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<std::uint32_t> phases, BatchKernel kernel);
+   UNITS_INLINE void PhaseAtan2(std::span<const double> y, std::span<const double> x, std::span<std::uint64_t> phases, BatchKernel kernel);
+
+   // sin and cos of angles in degrees, the nearest whole number of quarter
+   // turns is removed exactly before scaling to radians (see
+   // Trigonometry.h), within 2 ULP. Either output may be empty.
+   UNITS_INLINE void DegreesSinCos(std::span<const double> degrees, std::span<double> sines, std::span<double> cosines);
+   UNITS_INLINE void DegreesSinCos(std::span<const double> degrees, std::span<double> sines, std::span<double> cosines, BatchKernel kernel);
+
+   // degrees[i] = atan2(y[i], x[i]) in degrees within [-180, 180], within
+   // 3 ULP. (0, 0) gives 0.
+   UNITS_INLINE void DegreesAtan2(std::span<const double> y, std::span<const double> x, std::span<double> degrees);
+   UNITS_INLINE void DegreesAtan2(std::span<const double> y, std::span<const double> x, std::span<double> degrees, BatchKernel kernel);
+
+   // Sums of the sines and cosines of angles in degrees, without storing
+   // them. Each kernel adds in its own order, so the sums can differ between
+   // kernels in the last bits.
+   UNITS_INLINE void DegreesSinCosSums(std::span<const double> degrees, double& sineSum, double& cosineSum);
+   UNITS_INLINE void DegreesSinCosSums(std::span<const double> degrees, double& sineSum, double& cosineSum, BatchKernel kernel);
+
+   // Where WrapDegrees puts angles
+   //    Positive  [0, 360), as Angle::LimitAnglePositive
+   //    Signed    (-180, 180], as Angle::LimitAngle
+   enum class AngleWrap
+   {
+      Positive,
+      Signed
+   };
+
+   // wrapped[i] = degrees[i] less its whole circles, the same bits as
+   // Angle::WrapPositive / Angle::WrapSigned on every kernel. Exact, without
+   // fmod, magnitudes from 2^53 degrees are reduced one at a time after the
+   // vector pass. Infinity and NaN give NaN. wrapped may be the same memory
+   // as degrees. Throws std::invalid_argument if wrapped is smaller.
+   UNITS_INLINE void WrapDegrees(std::span<const double> degrees, std::span<double> wrapped, AngleWrap wrap);
+   UNITS_INLINE void WrapDegrees(std::span<const double> degrees, std::span<double> wrapped, AngleWrap wrap, BatchKernel kernel);
+
+   // norms[i] = sqrt(x[i]^2 + y[i]^2 + z[i]^2), the same bits on every
+   // kernel. No scaling against overflow, components beyond 1e154 give
+   // infinity.
+   UNITS_INLINE void VectorNorms(std::span<const double> x, std::span<const double> y, std::span<const double> z, std::span<double> norms);
+   UNITS_INLINE void VectorNorms(std::span<const double> x, std::span<const double> y, std::span<const double> z, std::span<double> norms, BatchKernel kernel);
+
+   // How IntegrateMotion advances one step of length dt
+   //    Euler              x += v * dt, then v += a * dt
+   //    SemiImplicitEuler  v += a * dt, then x += v * dt (symplectic, energy
+   //                       stays bounded for orbits and springs)
+   //    Verlet             velocity Verlet, v += (a' + a) * dt / 2, then
+   //                       x += v * dt + a * dt^2 / 2, then a' = a, where a'
+   //                       are the accelerations of the step before. Each
+   //                       step first finishes the velocities of the step
+   //                       before with the accelerations at the positions it
+   //                       reached, so between steps the velocities are those
+   //                       at the start of the last step, until FinishVerlet.
+   //                       Second order, symplectic and exact for constant
+   //                       acceleration. A NaN a' (no step before) leaves v
+   //                       as it is.
+   enum class Integrator
+   {
+      Euler,
+      SemiImplicitEuler,
+      Verlet
+   };
+
+   // Advances positions and velocities in place along one axis, with
+   // accelerations in the matching base units (meters, m/s, m/s^2). Verlet
+   // reads and then overwrites previousAccelerations, the other integrators
+   // ignore it and it may be empty for them. Products are rounded before
+   // they are added, so every kernel gives the same bits. Throws
+   // std::invalid_argument if the spans differ in size.
+   UNITS_INLINE void IntegrateMotion(std::span<double> positions, std::span<double> velocities, std::span<const double> accelerations,
+      std::span<double> previousAccelerations, double dt, Integrator integrator);
+   UNITS_INLINE void IntegrateMotion(std::span<double> positions, std::span<double> velocities, std::span<const double> accelerations,
+      std::span<double> previousAccelerations, double dt, Integrator integrator, BatchKernel kernel);
+
+   // Brings the velocities of a Verlet integration up to the positions, with
+   // the accelerations at those positions and the dt of the last step:
+   // v += (a' + a) * dt / 2, then a' = NaN. The next Verlet step then does
+   // not kick again and continues with the same bits as without finishing.
+   // Throws std::invalid_argument if the spans differ in size.
+   UNITS_INLINE void FinishVerlet(std::span<double> velocities, std::span<const double> accelerations, std::span<double> previousAccelerations,
+      double dt);
+   UNITS_INLINE void FinishVerlet(std::span<double> velocities, std::span<const double> accelerations, std::span<double> previousAccelerations,
+      double dt, BatchKernel kernel);
+} //end namespace Units
+
+#ifdef UNITS_HEADER_ONLY
+#include "UnitBatch.cpp"
+#endif
+
+#endif  // UNITBATCH_H_GUARD
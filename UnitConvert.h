@@ -0,0 +1,248 @@
+#ifndef UNITCONVERT_H_GUARD
+#define UNITCONVERT_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include "UnitBatch.h"
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+
+namespace Units
+{
+   // (fromNumerator / fromDenominator) / (toNumerator / toDenominator) rounded
+   // once to double, or fallback when the exact form overflows intmax_t
+   constexpr double RatioQuotient(std::intmax_t fromNumerator, std::intmax_t fromDenominator,
+      std::intmax_t toNumerator, std::intmax_t toDenominator, double fallback)
+   {
+      // (n1 / d1) / (n2 / d2) = (n1 * d2) / (d1 * n2), cross reduced first
+      const std::intmax_t numeratorGcd = std::gcd(fromNumerator, toNumerator);
+      const std::intmax_t denominatorGcd = std::gcd(fromDenominator, toDenominator);
+      const std::intmax_t n1 = fromNumerator / numeratorGcd;
+      const std::intmax_t n2 = toNumerator / numeratorGcd;
+      const std::intmax_t d1 = fromDenominator / denominatorGcd;
+      const std::intmax_t d2 = toDenominator / denominatorGcd;
+
+      if ((n1 > INTMAX_MAX / d2) || (d1 > INTMAX_MAX / n2))
+      {
+         return fallback;
+      }
+      const std::uint64_t numerator = std::uint64_t(n1 * d2);
+      const std::uint64_t denominator = std::uint64_t(d1 * n2);
+
+      // Both exact as doubles, the divide is the only rounding
+      constexpr std::uint64_t EXACT = std::uint64_t(1) << 53;
+      if ((numerator <= EXACT) && (denominator <= EXACT))
+      {
+         return double(numerator) / double(denominator);
+      }
+
+      // Otherwise long division to 54 bits, 53 and a round bit, with a
+      // sticky bit for the remainder, rounded to nearest even
+      std::uint64_t quotient = numerator / denominator;
+      std::uint64_t remainder = numerator % denominator;
+      int exponent = 0;
+      bool sticky = false;
+      while (quotient < EXACT)
+      {
+         remainder *= 2;
+         quotient = (quotient * 2) + ((remainder >= denominator) ? 1 : 0);
+         remainder -= (remainder >= denominator) ? denominator : 0;
+         --exponent;
+      }
+      while (quotient >= 2 * EXACT)
+      {
+         sticky = sticky || ((quotient & 1) != 0);
+         quotient /= 2;
+         ++exponent;
+      }
+      sticky = sticky || (remainder != 0);
+
+      std::uint64_t mantissa = quotient / 2;
+      if (((quotient & 1) != 0) && (sticky || ((mantissa & 1) != 0)))
+      {
+         ++mantissa;
+      }
+      double result = double(mantissa);
+      for (++exponent; exponent > 0; --exponent)
+      {
+         result *= 2.0;
+      }
+      for (; exponent < 0; ++exponent)
+      {
+         result /= 2.0;
+      }
+      return result;
+   }
+
+   // Conversion between two units of the same dimension, folded at compile
+   // time into a single  to = (from * factor) + offset  so converting a value
+   // costs one multiply (or one multiply and add for affine units such as
+   // Farenheit) instead of going to the base unit and back. Units made with
+   // UNIT_TEMPLATE_EQUATION are not affine and convert through the base unit.
+   template <class From, class To>
+   struct Conversion
+   {
+      static_assert(std::is_same_v<typename From::dimension, typename To::dimension>, "units must share a dimension");
+
+      static constexpr bool affine = From::affine && To::affine;
+
+   private:
+      // (From::exact_ratio / To::exact_ratio) rounded once to double, or the
+      // quotient of the two rounded scales when the exact form overflows
+      static constexpr double ExactFactor()
+      {
+         using FromRatio = typename From::exact_ratio;
+         using ToRatio = typename To::exact_ratio;
+
+         return RatioQuotient(FromRatio::num, FromRatio::den, ToRatio::num, ToRatio::den, From::scale / To::scale);
+      }
+
+      static constexpr double ComposeFactor()
+      {
+         if constexpr (!affine)
+         {
+            return 1.0;
+         }
+         else if constexpr (requires { typename From::exact_ratio; typename To::exact_ratio; })
+         {
+            return ExactFactor();
+         }
+         else
+         {
+            return From::scale / To::scale;
+         }
+      }
+
+      static constexpr double ComposeOffset()
+      {
+         if constexpr (!affine)
+         {
+            return 0.0;
+         }
+         else
+         {
+            return (From::offset - To::offset) / To::scale;
+         }
+      }
+
+   public:
+      static constexpr double factor = ComposeFactor();
+      static constexpr double offset = ComposeOffset();
+
+      static constexpr double Apply(double value)
+      {
+         if constexpr (!affine)
+         {
+            return To(From(value)).value();
+         }
+         else if constexpr (offset == 0.0)
+         {
+            return value * factor;
+         }
+         else
+         {
+            // Kept as a separate multiply and add so the batch kernels, which
+            // must also run on SSE2, produce the same bits
+            return (value * factor) + offset;
+         }
+      }
+   };
+
+   // Units made with UNIT_TEMPLATE_DECIBEL
+   template <class Unit>
+   concept DecibelUnit = requires { requires Unit::decibel; };
+
+   // Units with base = input * scale
+   template <class Unit>
+   concept LinearUnit = requires { requires Unit::affine && (Unit::offset == 0.0); };
+
+   // Units::convert<Units::Feet, Units::NauticalMiles>(altitude)
+   template <class From, class To>
+   constexpr double convert(double value)
+   {
+      return Conversion<From, To>::Apply(value);
+   }
+
+   // Converts every value of input into output, which may be the same memory.
+   // Affine conversions run on the SIMD kernels of UnitBatch.h and match the
+   // scalar convert bit for bit. Conversions between decibel and linear units
+   // run on the logarithmic kernels at the given precision, within a few ULP
+   // of the scalar convert for Strict.
+   template <class From, class To>
+   void convert(std::span<const double> input, std::span<double> output, BatchPrecision precision = BatchPrecision::Strict)
+   {
+      if (output.size() < input.size())
+      {
+         throw std::invalid_argument("Units::convert output is smaller than input");
+      }
+
+      if constexpr (Conversion<From, To>::affine)
+      {
+         ScaleOffset(input, output, Conversion<From, To>::factor, Conversion<From, To>::offset);
+      }
+      else if constexpr (DecibelUnit<From> && LinearUnit<To>)
+      {
+         DecibelsToRatio(input, output, From::reference / To::scale, precision);
+      }
+      else if constexpr (LinearUnit<From> && DecibelUnit<To>)
+      {
+         RatioToDecibels(input, output, From::scale / To::reference, precision);
+      }
+      else if constexpr (DecibelUnit<From> && DecibelUnit<To>)
+      {
+         ScaleOffset(input, output, 1.0, 10.0 * std::log10(From::reference / To::reference));
+      }
+      else
+      {
+         const std::size_t count = input.size();
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            output[i] = Conversion<From, To>::Apply(input[i]);
+         }
+      }
+   }
+
+   // Single precision values, affine conversions run on the float kernels
+   // (twice the values per vector) with the factor and offset rounded to
+   // float, other conversions are worked out in double one value at a time
+   template <class From, class To>
+   void convert(std::span<const float> input, std::span<float> output)
+   {
+      if (output.size() < input.size())
+      {
+         throw std::invalid_argument("Units::convert output is smaller than input");
+      }
+
+      if constexpr (Conversion<From, To>::affine)
+      {
+         ScaleOffset(input, output, float(Conversion<From, To>::factor), float(Conversion<From, To>::offset));
+      }
+      else
+      {
+         const std::size_t count = input.size();
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            output[i] = float(Conversion<From, To>::Apply(double(input[i])));
+         }
+      }
+   }
+} //end namespace Units
+
+#endif  // UNITCONVERT_H_GUARD
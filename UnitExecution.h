@@ -0,0 +1,53 @@
+#ifndef UNITEXECUTION_H_GUARD
+#define UNITEXECUTION_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitParallel.h"
+#include <execution>
+#include <type_traits>
+
+// Lets the ThreadPool overloads of UnitParallel.h, Kinematics.h and
+// Calculus.h take a standard execution policy instead. Kept apart because
+// <execution> is most of the parse time of those headers.
+//    Units::Assign(std::execution::par, speed, distance / elapsed);
+
+namespace Units
+{
+   namespace Parallel
+   {
+      // par and par_unseq run on ThreadPool::Default(), seq and unseq on the
+      // calling thread
+      template <class Policy>
+         requires std::is_execution_policy_v<Policy>
+      struct PolicyPool<Policy>
+      {
+         static ThreadPool* Get()
+         {
+            if constexpr (std::is_same_v<Policy, std::execution::parallel_policy> || std::is_same_v<Policy, std::execution::parallel_unsequenced_policy>)
+            {
+               return &ThreadPool::Default();
+            }
+            else
+            {
+               return nullptr;
+            }
+         }
+      };
+   } //end namespace Parallel
+} //end namespace Units
+
+#endif  // UNITEXECUTION_H_GUARD
@@ -0,0 +1,61 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#ifndef UNITFORMAT_CPP_GUARD
+#define UNITFORMAT_CPP_GUARD
+
+#include "UnitFormat.h"
+#include <cstring>
+
+namespace Units
+{
+   UNITS_INLINE std::to_chars_result FormatValue(char* first, char* last, double value, std::string_view suffix, int precision)
+   {
+      const std::to_chars_result number = (precision < 0) ? std::to_chars(first, last, value) :
+         std::to_chars(first, last, value, std::chars_format::fixed, precision);
+      if (number.ec != std::errc())
+      {
+         return number;
+      }
+      if (std::size_t(last - number.ptr) < suffix.size())
+      {
+         return { last, std::errc::value_too_large };
+      }
+      std::memcpy(number.ptr, suffix.data(), suffix.size());
+      return { number.ptr + suffix.size(), std::errc() };
+   }
+
+   UNITS_INLINE FormatResult FormatColumn(std::span<char> output, std::span<const double> values, std::string_view suffix, char separator, int precision)
+   {
+      char* const last = output.data() + output.size();
+      FormatResult result{ output.data(), std::errc(), 0 };
+      for (const double value : values)
+      {
+         const std::to_chars_result field = FormatValue(result.ptr, last, value, suffix, precision);
+         if ((field.ec != std::errc()) || (field.ptr == last))
+         {
+            result.ec = std::errc::value_too_large;
+            return result;
+         }
+         *field.ptr = separator;
+         result.ptr = field.ptr + 1;
+         ++result.count;
+      }
+      return result;
+   }
+} //end namespace Units
+
+#endif  // UNITFORMAT_CPP_GUARD
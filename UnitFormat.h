@@ -0,0 +1,193 @@
+#ifndef UNITFORMAT_H_GUARD
+#define UNITFORMAT_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <version>
+
+namespace Units
+{
+   // Precision giving the shortest text that parses back to the same double
+   inline constexpr int SHORTEST_ROUND_TRIP = -1;
+
+   // Any unit type (not a bare Quantity), the suffix written is its user literal
+   template <class Unit>
+   concept FormattableUnit = requires { { Unit::suffix } -> std::convertible_to<std::string_view>; };
+
+   // Outcome of formatting a column, ptr is one past the last complete field
+   // and ec is value_too_large if the output ran out before every value
+   struct FormatResult
+   {
+      char* ptr;
+      std::errc ec;
+      std::size_t count;
+   };
+
+   // Writes "<number><suffix>" to [first, last) with std::to_chars, the
+   // shortest round trip number or fixed notation with precision digits after
+   // the point. Locale independent, never allocates or throws. As with
+   // std::to_chars the range is left unspecified on value_too_large.
+   UNITS_INLINE std::to_chars_result FormatValue(char* first, char* last, double value, std::string_view suffix, int precision = SHORTEST_ROUND_TRIP);
+
+   // Writes every value as FormatValue does, each followed by separator
+   UNITS_INLINE FormatResult FormatColumn(std::span<char> output, std::span<const double> values, std::string_view suffix, char separator, int precision);
+
+   // char buffer[64];
+   // auto result = Units::Format(buffer, buffer + sizeof(buffer), Units::Feet(35000.0)); // "35000ft"
+   template <FormattableUnit Unit>
+   std::to_chars_result Format(char* first, char* last, const Unit& unit, int precision = SHORTEST_ROUND_TRIP)
+   {
+      return FormatValue(first, last, unit.value(), Unit::suffix, precision);
+   }
+
+   // Formats quantities of any unit of Unit's dimension in Unit
+   template <FormattableUnit Unit>
+   FormatResult FormatColumn(std::span<char> output, std::span<const Quantity<typename Unit::dimension>> quantities,
+      char separator = '\n', int precision = SHORTEST_ROUND_TRIP)
+   {
+      // Converted a block at a time so the conversion loop vectorizes
+      constexpr std::size_t BLOCK = 256;
+      double values[BLOCK];
+
+      FormatResult result{ output.data(), std::errc(), 0 };
+      for (std::size_t first = 0; first < quantities.size(); first += BLOCK)
+      {
+         const std::size_t count = std::min(BLOCK, quantities.size() - first);
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            values[i] = Unit(quantities[first + i]).value();
+         }
+
+         const std::span<char> remaining = output.subspan(std::size_t(result.ptr - output.data()));
+         const FormatResult block = FormatColumn(remaining, std::span<const double>(values, count), Unit::suffix, separator, precision);
+         result.ptr = block.ptr;
+         result.ec = block.ec;
+         result.count += block.count;
+         if (block.ec != std::errc())
+         {
+            break;
+         }
+      }
+      return result;
+   }
+
+   namespace Formatting
+   {
+      // Largest precision a format spec may ask for
+      inline constexpr int MAX_PRECISION = 100;
+      // Sign, the 309 integer digits of DBL_MAX, point and fraction
+      inline constexpr std::size_t MAX_NUMBER_LENGTH = 1 + 309 + 1 + MAX_PRECISION;
+
+      // Reads the optional ".N" of "{:.N}" up to the closing brace, false on
+      // a malformed spec
+      template <class Iterator>
+      constexpr bool ParseSpec(Iterator& first, Iterator last, int& precision)
+      {
+         if ((first != last) && (*first == '.'))
+         {
+            ++first;
+            int digits = 0;
+            int value = 0;
+            while ((first != last) && (*first >= '0') && (*first <= '9') && (value <= MAX_PRECISION))
+            {
+               value = (value * 10) + (*first - '0');
+               ++digits;
+               ++first;
+            }
+            if ((digits == 0) || (value > MAX_PRECISION))
+            {
+               return false;
+            }
+            precision = value;
+         }
+         return (first == last) || (*first == '}');
+      }
+
+      template <FormattableUnit Unit, class OutputIterator>
+      OutputIterator Write(const Unit& unit, int precision, OutputIterator output)
+      {
+         char buffer[MAX_NUMBER_LENGTH + Unit::suffix.size()];
+         const std::to_chars_result result = Format(buffer, buffer + sizeof(buffer), unit, precision);
+         return std::copy(buffer, result.ptr, output);
+      }
+   } //end namespace Formatting
+} //end namespace Units
+
+// std::format("{}", Units::Knots(250.0)) gives "250kt", "{:.2}" fixed with two decimals
+#ifdef __cpp_lib_format
+#include <format>
+
+template <Units::FormattableUnit Unit>
+struct std::formatter<Unit, char>
+{
+   int precision = Units::SHORTEST_ROUND_TRIP;
+
+   constexpr std::format_parse_context::iterator parse(std::format_parse_context& context)
+   {
+      std::format_parse_context::iterator end = context.begin();
+      if (!Units::Formatting::ParseSpec(end, context.end(), precision))
+      {
+         throw std::format_error("Units::formatter format spec must be empty or .precision");
+      }
+      return end;
+   }
+
+   template <class FormatContext>
+   typename FormatContext::iterator format(const Unit& unit, FormatContext& context) const
+   {
+      return Units::Formatting::Write(unit, precision, context.out());
+   }
+};
+#endif
+
+// Same formatter for the fmt library when it is included first
+#ifdef FMT_VERSION
+template <Units::FormattableUnit Unit>
+struct fmt::formatter<Unit, char>
+{
+   int precision = Units::SHORTEST_ROUND_TRIP;
+
+   constexpr fmt::format_parse_context::iterator parse(fmt::format_parse_context& context)
+   {
+      fmt::format_parse_context::iterator end = context.begin();
+      if (!Units::Formatting::ParseSpec(end, context.end(), precision))
+      {
+         throw fmt::format_error("Units::formatter format spec must be empty or .precision");
+      }
+      return end;
+   }
+
+   template <class FormatContext>
+   typename FormatContext::iterator format(const Unit& unit, FormatContext& context) const
+   {
+      return Units::Formatting::Write(unit, precision, context.out());
+   }
+};
+#endif
+
+#ifdef UNITS_HEADER_ONLY
+#include "UnitFormat.cpp"
+#endif
+
+#endif  // UNITFORMAT_H_GUARD
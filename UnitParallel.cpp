@@ -0,0 +1,218 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#ifndef UNITPARALLEL_CPP_GUARD
+#define UNITPARALLEL_CPP_GUARD
+
+#include "UnitParallel.h"
+
+namespace Units
+{
+   namespace Parallel
+   {
+      // Chunk ranges hold 32 bit indices, larger jobs get larger chunks
+      constexpr std::uint64_t MAX_CHUNKS = std::uint64_t(1) << 31;
+
+      constexpr std::uint64_t PackRange(std::uint64_t begin, std::uint64_t end) { return begin | (end << 32); }
+      constexpr std::uint64_t RangeBegin(std::uint64_t range) { return range & 0xFFFFFFFFu; }
+      constexpr std::uint64_t RangeEnd(std::uint64_t range) { return range >> 32; }
+
+      // Set on pool threads and on a caller while it runs a job
+      inline bool& InsideJob()
+      {
+         thread_local bool inside = false;
+         return inside;
+      }
+   } //end namespace Parallel
+
+   UNITS_INLINE ThreadPool::ThreadPool(unsigned threads)
+   {
+      if (threads == 0)
+      {
+         threads = std::max(1u, std::thread::hardware_concurrency());
+      }
+      m_ranges = std::make_unique<ChunkRange[]>(threads);
+      m_workers.reserve(threads - 1);
+      for (unsigned slot = 1; slot < threads; ++slot)
+      {
+         m_workers.emplace_back([this, slot] { Work(slot); });
+      }
+   }
+
+   UNITS_INLINE ThreadPool::~ThreadPool()
+   {
+      {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         m_stopping = true;
+      }
+      m_wake.notify_all();
+      for (std::thread& worker : m_workers)
+      {
+         worker.join();
+      }
+   }
+
+   UNITS_INLINE ThreadPool& ThreadPool::Default()
+   {
+      static ThreadPool pool;
+      return pool;
+   }
+
+   UNITS_INLINE void ThreadPool::Run(std::size_t count, std::size_t chunk, ChunkFunction function, void* context)
+   {
+      if (count == 0)
+      {
+         return;
+      }
+      chunk = std::max<std::size_t>(chunk, 1);
+      if (m_workers.empty() || (count <= chunk) || Parallel::InsideJob())
+      {
+         function(context, 0, count);
+         return;
+      }
+
+      std::lock_guard<std::mutex> run(m_runMutex);
+      chunk = std::max<std::size_t>(chunk, std::size_t((std::uint64_t(count) + Parallel::MAX_CHUNKS - 1) / Parallel::MAX_CHUNKS));
+      const std::uint64_t chunks = (std::uint64_t(count) + chunk - 1) / chunk;
+      const unsigned threads = Threads();
+      for (unsigned slot = 0; slot < threads; ++slot)
+      {
+         m_ranges[slot].chunks.store(Parallel::PackRange((chunks * slot) / threads, (chunks * (slot + 1)) / threads), std::memory_order_relaxed);
+      }
+      m_function = function;
+      m_context = context;
+      m_count = count;
+      m_chunk = chunk;
+      m_failed.store(false, std::memory_order_relaxed);
+      m_error = nullptr;
+
+      {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         ++m_generation;
+         m_busy = unsigned(m_workers.size());
+      }
+      m_wake.notify_all();
+
+      Parallel::InsideJob() = true;
+      Drain(0);
+      Parallel::InsideJob() = false;
+
+      {
+         std::unique_lock<std::mutex> lock(m_mutex);
+         m_idle.wait(lock, [this] { return m_busy == 0; });
+      }
+      if (m_error)
+      {
+         std::rethrow_exception(m_error);
+      }
+   }
+
+   UNITS_INLINE void ThreadPool::Work(unsigned slot)
+   {
+      Parallel::InsideJob() = true;
+      std::uint64_t seen = 0;
+      while (true)
+      {
+         {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || (m_generation != seen); });
+            if (m_stopping)
+            {
+               return;
+            }
+            seen = m_generation;
+         }
+
+         Drain(slot);
+
+         {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_busy;
+         }
+         m_idle.notify_one();
+      }
+   }
+
+   // Runs chunks until none is left anywhere, every chunk taken is finished
+   // before returning so the job is done once every thread has returned
+   UNITS_INLINE void ThreadPool::Drain(unsigned slot)
+   {
+      std::size_t index = 0;
+      while (Pop(slot, index) || Steal(slot, index))
+      {
+         if (m_failed.load(std::memory_order_relaxed))
+         {
+            continue;
+         }
+         const std::size_t begin = index * m_chunk;
+         const std::size_t end = std::min(m_count, begin + m_chunk);
+         try
+         {
+            m_function(m_context, begin, end);
+         }
+         catch (...)
+         {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_failed.exchange(true))
+            {
+               m_error = std::current_exception();
+            }
+         }
+      }
+   }
+
+   UNITS_INLINE bool ThreadPool::Pop(unsigned slot, std::size_t& index)
+   {
+      std::atomic<std::uint64_t>& chunks = m_ranges[slot].chunks;
+      std::uint64_t range = chunks.load(std::memory_order_acquire);
+      while (Parallel::RangeBegin(range) < Parallel::RangeEnd(range))
+      {
+         if (chunks.compare_exchange_weak(range, Parallel::PackRange(Parallel::RangeBegin(range) + 1, Parallel::RangeEnd(range)), std::memory_order_acq_rel))
+         {
+            index = std::size_t(Parallel::RangeBegin(range));
+            return true;
+         }
+      }
+      return false;
+   }
+
+   // Takes the upper half of the first other range with work left, keeps one
+   // chunk and makes the rest this thread's range
+   UNITS_INLINE bool ThreadPool::Steal(unsigned slot, std::size_t& index)
+   {
+      const unsigned threads = Threads();
+      for (unsigned offset = 1; offset < threads; ++offset)
+      {
+         std::atomic<std::uint64_t>& victim = m_ranges[(slot + offset) % threads].chunks;
+         std::uint64_t range = victim.load(std::memory_order_acquire);
+         while (Parallel::RangeBegin(range) < Parallel::RangeEnd(range))
+         {
+            const std::uint64_t begin = Parallel::RangeBegin(range);
+            const std::uint64_t end = Parallel::RangeEnd(range);
+            const std::uint64_t middle = begin + ((end - begin) / 2);
+            if (victim.compare_exchange_weak(range, Parallel::PackRange(begin, middle), std::memory_order_acq_rel))
+            {
+               index = std::size_t(middle);
+               m_ranges[slot].chunks.store(Parallel::PackRange(middle + 1, end), std::memory_order_release);
+               return true;
+            }
+         }
+      }
+      return false;
+   }
+} //end namespace Units
+
+#endif  // UNITPARALLEL_CPP_GUARD
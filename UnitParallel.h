@@ -0,0 +1,339 @@
+#ifndef UNITPARALLEL_H_GUARD
+#define UNITPARALLEL_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include "AngleType.h"
+#include "ArrayExpression.h"
+#include "QuantityArray.h"
+#include "UnitBatch.h"
+#include "UnitConvert.h"
+#include "UnitRegistry.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Units
+{
+   // Work stealing pool for the bulk operations below. A job is a range of
+   // chunks split evenly over the threads up front, a thread that runs out
+   // takes half of what is left of another thread's range. The calling
+   // thread works on the job too and Run returns once every chunk is done.
+   // Jobs started from inside a job run serially on the calling thread.
+   class ThreadPool
+   {
+   public:
+      // threads counts the calling thread, 0 for every hardware thread
+      UNITS_INLINE explicit ThreadPool(unsigned threads = 0);
+      UNITS_INLINE ~ThreadPool();
+
+      ThreadPool(const ThreadPool&) = delete;
+      ThreadPool& operator=(const ThreadPool&) = delete;
+
+      unsigned Threads() const { return unsigned(m_workers.size()) + 1; }
+
+      // Shared pool of every hardware thread, used for parallel execution policies
+      UNITS_INLINE static ThreadPool& Default();
+
+      // Calls function(begin, end) over [0, count) in pieces of chunk
+      // elements. The first exception thrown is rethrown once every thread
+      // has stopped.
+      template <class Function>
+      void Run(std::size_t count, std::size_t chunk, Function&& function)
+      {
+         using Callable = std::remove_reference_t<Function>;
+         Run(count, chunk, [](void* context, std::size_t begin, std::size_t end) { (*static_cast<Callable*>(context))(begin, end); },
+            const_cast<void*>(static_cast<const void*>(std::addressof(function))));
+      }
+
+   private:
+      using ChunkFunction = void (*)(void* context, std::size_t begin, std::size_t end);
+
+      // Chunk indices still to do by one thread, begin in the low half and
+      // end in the high half so both move with one compare exchange
+      struct alignas(64) ChunkRange
+      {
+         std::atomic<std::uint64_t> chunks{ 0 };
+      };
+
+      UNITS_INLINE void Run(std::size_t count, std::size_t chunk, ChunkFunction function, void* context);
+      UNITS_INLINE void Work(unsigned slot);
+      UNITS_INLINE void Drain(unsigned slot);
+      UNITS_INLINE bool Pop(unsigned slot, std::size_t& index);
+      UNITS_INLINE bool Steal(unsigned slot, std::size_t& index);
+
+      std::vector<std::thread> m_workers;
+      std::unique_ptr<ChunkRange[]> m_ranges;
+
+      std::mutex m_runMutex;
+      std::mutex m_mutex;
+      std::condition_variable m_wake;
+      std::condition_variable m_idle;
+      std::uint64_t m_generation = 0;
+      unsigned m_busy = 0;
+      bool m_stopping = false;
+
+      // The running job
+      ChunkFunction m_function = nullptr;
+      void* m_context = nullptr;
+      std::size_t m_count = 0;
+      std::size_t m_chunk = 0;
+      std::atomic<bool> m_failed{ false };
+      std::exception_ptr m_error;
+   };
+
+   namespace Parallel
+   {
+      // Chunks are sized so the data one chunk streams through stays within
+      // half of a 512 KiB L2, and are whole cache lines of doubles
+      inline constexpr std::size_t L2_CHUNK_BYTES = 256 * 1024;
+      inline constexpr std::size_t MIN_CHUNK = 1024;
+
+      constexpr std::size_t ChunkOf(std::size_t bytesPerElement)
+      {
+         return std::max(MIN_CHUNK, ((L2_CHUNK_BYTES / bytesPerElement) / 8) * 8);
+      }
+
+      // Pool a standard execution policy runs on, Get() is only declared for
+      // the policies by UnitExecution.h, so the headers here do not pull in
+      // <execution> and the policy overloads below need UnitExecution.h
+      template <class Policy>
+      struct PolicyPool
+      {
+      };
+
+      template <class Policy>
+      concept ExecutionPolicy = requires { PolicyPool<std::remove_cvref_t<Policy>>::Get(); };
+
+      // The pool a policy runs on, nullptr for the sequenced and unsequenced
+      // policies which run on the calling thread
+      template <ExecutionPolicy Policy>
+      ThreadPool* PoolOf(const Policy&)
+      {
+         return PolicyPool<std::remove_cvref_t<Policy>>::Get();
+      }
+
+      // function(begin, end) over [0, count), on pool or on the calling thread
+      template <class Function>
+      void ForEach(ThreadPool* pool, std::size_t count, std::size_t chunk, Function&& function)
+      {
+         if (pool == nullptr)
+         {
+            function(std::size_t(0), count);
+         }
+         else
+         {
+            pool->Run(count, chunk, function);
+         }
+      }
+
+      // Reduces each chunk with reduce(begin, end) and combines the partial
+      // results in chunk order, so the result does not depend on the thread count
+      template <class Result, class Reducer, class Combiner>
+      Result Reduce(ThreadPool* pool, std::size_t count, std::size_t chunk, Result identity, Reducer&& reduce, Combiner&& combine)
+      {
+         std::vector<Result> partials((count + chunk - 1) / chunk, identity);
+         ForEach(pool, count, chunk, [&](std::size_t begin, std::size_t end)
+         {
+            for (std::size_t first = begin; first < end; first += chunk)
+            {
+               partials[first / chunk] = reduce(first, std::min(end, first + chunk));
+            }
+         });
+
+         Result result = identity;
+         for (const Result& partial : partials)
+         {
+            result = combine(result, partial);
+         }
+         return result;
+      }
+
+      template <class From, class To>
+      void Convert(ThreadPool* pool, std::span<const double> input, std::span<double> output, BatchPrecision precision)
+      {
+         if (output.size() < input.size())
+         {
+            throw std::invalid_argument("Units::convert output is smaller than input");
+         }
+         ForEach(pool, input.size(), ChunkOf(2 * sizeof(double)), [&](std::size_t begin, std::size_t end)
+         {
+            convert<From, To>(input.subspan(begin, end - begin), output.subspan(begin, end - begin), precision);
+         });
+      }
+
+      inline void Convert(ThreadPool* pool, std::span<const double> input, std::span<double> output, UnitId from, UnitId to)
+      {
+         if (output.size() < input.size())
+         {
+            throw std::invalid_argument("Units::convert output is smaller than input");
+         }
+         ForEach(pool, input.size(), ChunkOf(2 * sizeof(double)), [&](std::size_t begin, std::size_t end)
+         {
+            convert(input.subspan(begin, end - begin), output.subspan(begin, end - begin), from, to);
+         });
+      }
+
+      template <class Element, class Expression>
+      void Assign(ThreadPool* pool, QuantityArray<Element>& target, const Expression& expression)
+      {
+         if (expression.size() != target.size())
+         {
+            target = QuantityArray<Element>(expression.size(), target.Memory());
+         }
+         const auto operand = ArrayExpressions::OperandOf<Expression>::Make(expression);
+         double* const values = target.Values().data();
+         ForEach(pool, target.size(), ChunkOf(4 * sizeof(double)), [&](std::size_t begin, std::size_t end)
+         {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+               values[i] = operand.Evaluate(i);
+            }
+         });
+      }
+
+      template <bool Positive>
+      void LimitAngles(ThreadPool* pool, std::span<Angle> angles)
+      {
+         ForEach(pool, angles.size(), ChunkOf(sizeof(double)), [&](std::size_t begin, std::size_t end)
+         {
+            if constexpr (Positive)
+            {
+               Units::LimitAnglePositive(angles.subspan(begin, end - begin));
+            }
+            else
+            {
+               Units::LimitAngle(angles.subspan(begin, end - begin));
+            }
+         });
+      }
+
+      template <class QuantityType>
+      QuantityType Sum(ThreadPool* pool, std::span<const QuantityType> values)
+      {
+         return Reduce(pool, values.size(), ChunkOf(sizeof(double)), QuantityType::zero(), [&](std::size_t begin, std::size_t end)
+         {
+            QuantityType sum = QuantityType::zero();
+            for (std::size_t i = begin; i < end; ++i)
+            {
+               sum += values[i];
+            }
+            return sum;
+         }, [](const QuantityType& lhs, const QuantityType& rhs) { return lhs + rhs; });
+      }
+
+      template <bool Maximum, class QuantityType>
+      QuantityType Extreme(ThreadPool* pool, std::span<const QuantityType> values)
+      {
+         if (values.empty())
+         {
+            throw std::invalid_argument("Units::Minimum / Maximum of no values");
+         }
+         const auto pick = [](const QuantityType& lhs, const QuantityType& rhs) { return (Maximum ? (rhs > lhs) : (rhs < lhs)) ? rhs : lhs; };
+         return Reduce(pool, values.size(), ChunkOf(sizeof(double)), values[0], [&](std::size_t begin, std::size_t end)
+         {
+            QuantityType extreme = values[begin];
+            for (std::size_t i = begin + 1; i < end; ++i)
+            {
+               extreme = pick(extreme, values[i]);
+            }
+            return extreme;
+         }, pick);
+      }
+   } //end namespace Parallel
+
+   // Parallel bulk operations, each taking a ThreadPool or, with
+   // UnitExecution.h, a standard execution policy (std::execution::par and
+   // par_unseq run on ThreadPool::Default(), seq and unseq on the calling
+   // thread). The results are the same as the serial versions for any
+   // thread count.
+
+   // Units::convert<Units::Feet, Units::Meters>(pool, feet, meters);
+   template <class From, class To>
+   void convert(ThreadPool& pool, std::span<const double> input, std::span<double> output, BatchPrecision precision = BatchPrecision::Strict)
+   {
+      Parallel::Convert<From, To>(&pool, input, output, precision);
+   }
+   template <class From, class To, Parallel::ExecutionPolicy Policy>
+   void convert(Policy&& policy, std::span<const double> input, std::span<double> output, BatchPrecision precision = BatchPrecision::Strict)
+   {
+      Parallel::Convert<From, To>(Parallel::PoolOf(policy), input, output, precision);
+   }
+
+   inline void convert(ThreadPool& pool, std::span<const double> input, std::span<double> output, UnitId from, UnitId to)
+   {
+      Parallel::Convert(&pool, input, output, from, to);
+   }
+   template <Parallel::ExecutionPolicy Policy>
+   void convert(Policy&& policy, std::span<const double> input, std::span<double> output, UnitId from, UnitId to)
+   {
+      Parallel::Convert(Parallel::PoolOf(policy), input, output, from, to);
+   }
+
+   // Evaluates an array expression into target, e.g. speed = distance / time
+   template <class Element, class Expression>
+      requires ArrayExpressionOf<Expression, Element>
+   void Assign(ThreadPool& pool, QuantityArray<Element>& target, const Expression& expression)
+   {
+      Parallel::Assign(&pool, target, expression);
+   }
+   template <Parallel::ExecutionPolicy Policy, class Element, class Expression>
+      requires ArrayExpressionOf<Expression, Element>
+   void Assign(Policy&& policy, QuantityArray<Element>& target, const Expression& expression)
+   {
+      Parallel::Assign(Parallel::PoolOf(policy), target, expression);
+   }
+
+   inline void LimitAnglePositive(ThreadPool& pool, std::span<Angle> angles) { Parallel::LimitAngles<true>(&pool, angles); }
+   inline void LimitAngle(ThreadPool& pool, std::span<Angle> angles) { Parallel::LimitAngles<false>(&pool, angles); }
+   template <Parallel::ExecutionPolicy Policy>
+   void LimitAnglePositive(Policy&& policy, std::span<Angle> angles) { Parallel::LimitAngles<true>(Parallel::PoolOf(policy), angles); }
+   template <Parallel::ExecutionPolicy Policy>
+   void LimitAngle(Policy&& policy, std::span<Angle> angles) { Parallel::LimitAngles<false>(Parallel::PoolOf(policy), angles); }
+
+   // Sum of every value, summed per chunk then across chunks in order
+   template <class QuantityType>
+   QuantityType Sum(ThreadPool& pool, std::span<const QuantityType> values) { return Parallel::Sum(&pool, values); }
+   template <class QuantityType, Parallel::ExecutionPolicy Policy>
+   QuantityType Sum(Policy&& policy, std::span<const QuantityType> values) { return Parallel::Sum(Parallel::PoolOf(policy), values); }
+
+   // Throw std::invalid_argument for no values
+   template <class QuantityType>
+   QuantityType Minimum(ThreadPool& pool, std::span<const QuantityType> values) { return Parallel::Extreme<false>(&pool, values); }
+   template <class QuantityType>
+   QuantityType Maximum(ThreadPool& pool, std::span<const QuantityType> values) { return Parallel::Extreme<true>(&pool, values); }
+   template <class QuantityType, Parallel::ExecutionPolicy Policy>
+   QuantityType Minimum(Policy&& policy, std::span<const QuantityType> values) { return Parallel::Extreme<false>(Parallel::PoolOf(policy), values); }
+   template <class QuantityType, Parallel::ExecutionPolicy Policy>
+   QuantityType Maximum(Policy&& policy, std::span<const QuantityType> values) { return Parallel::Extreme<true>(Parallel::PoolOf(policy), values); }
+} //end namespace Units
+
+#ifdef UNITS_HEADER_ONLY
+#include "UnitParallel.cpp"
+#endif
+
+#endif  // UNITPARALLEL_H_GUARD
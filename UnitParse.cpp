@@ -0,0 +1,172 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#ifndef UNITPARSE_CPP_GUARD
+#define UNITPARSE_CPP_GUARD
+
+#include "UnitParse.h"
+#include <charconv>
+#include <system_error>
+
+namespace Units
+{
+   namespace Parsing
+   {
+      constexpr bool IsBlank(char character)
+      {
+         return (character == ' ') || (character == '\t') || (character == '\r');
+      }
+
+      constexpr std::string_view Trim(std::string_view text)
+      {
+         while (!text.empty() && IsBlank(text.front()))
+         {
+            text.remove_prefix(1);
+         }
+         while (!text.empty() && IsBlank(text.back()))
+         {
+            text.remove_suffix(1);
+         }
+         return text;
+      }
+
+      // Same arithmetic as constructing the unit from value
+      inline double ToBase(const UnitRecord& record, double value)
+      {
+         if (record.affine)
+         {
+            return (record.offset == 0.0) ? (value * record.scale) : ((value * record.scale) + record.offset);
+         }
+         return record.ToBase(value);
+      }
+
+      // Splits a field into its number and its suffix
+      inline ParseError Split(std::string_view text, double& value, std::string_view& suffix)
+      {
+         text = Trim(text);
+         const char* first = text.data();
+         const char* last = first + text.size();
+         // from_chars takes no leading plus
+         if ((first != last) && (*first == '+'))
+         {
+            ++first;
+         }
+
+         const std::from_chars_result number = std::from_chars(first, last, value);
+         if (number.ec != std::errc())
+         {
+            return ParseError::InvalidNumber;
+         }
+
+         suffix = Trim(std::string_view(number.ptr, std::size_t(last - number.ptr)));
+         return suffix.empty() ? ParseError::MissingUnit : ParseError::None;
+      }
+   } //end namespace Parsing
+
+   UNITS_INLINE ParseError ParseQuantity(std::string_view text, double& baseValue, UnitId& unit)
+   {
+      double value = 0.0;
+      std::string_view suffix;
+      const ParseError error = Parsing::Split(text, value, suffix);
+      if (error != ParseError::None)
+      {
+         return error;
+      }
+
+      const UnitId found = FindUnit(suffix);
+      if (found == UnitId::Invalid)
+      {
+         return ParseError::UnknownUnit;
+      }
+
+      unit = found;
+      baseValue = Parsing::ToBase(GetUnitRecord(found), value);
+      return ParseError::None;
+   }
+
+   UNITS_INLINE ParseError ParseQuantity(std::string_view text, DimensionId dimension, double& baseValue)
+   {
+      UnitId unit = UnitId::Invalid;
+      double value = 0.0;
+      const ParseError error = ParseQuantity(text, value, unit);
+      if (error != ParseError::None)
+      {
+         return error;
+      }
+      if (GetUnitRecord(unit).dimension != dimension)
+      {
+         return ParseError::WrongDimension;
+      }
+      baseValue = value;
+      return ParseError::None;
+   }
+
+   UNITS_INLINE ParseResult ParseColumn(std::string_view column, char separator, DimensionId dimension, std::span<double> baseValues)
+   {
+      ParseResult result{ ParseError::None, 0, 0 };
+      // Columns mostly repeat one unit, the last suffix skips the lookup
+      std::string_view lastSuffix;
+      const UnitRecord* lastRecord = nullptr;
+
+      std::size_t position = 0;
+      while (position < column.size())
+      {
+         std::size_t end = column.find(separator, position);
+         if (end == std::string_view::npos)
+         {
+            end = column.size();
+         }
+
+         const std::string_view field = column.substr(position, end - position);
+         if (!Parsing::Trim(field).empty())
+         {
+            double value = 0.0;
+            std::string_view suffix;
+            result.error = (result.count == baseValues.size()) ? ParseError::OutputTooSmall : Parsing::Split(field, value, suffix);
+            if ((result.error == ParseError::None) && ((lastRecord == nullptr) || (suffix != lastSuffix)))
+            {
+               const UnitId unit = FindUnit(suffix);
+               if (unit == UnitId::Invalid)
+               {
+                  result.error = ParseError::UnknownUnit;
+               }
+               else if (GetUnitRecord(unit).dimension != dimension)
+               {
+                  result.error = ParseError::WrongDimension;
+               }
+               else
+               {
+                  lastSuffix = suffix;
+                  lastRecord = &GetUnitRecord(unit);
+               }
+            }
+            if (result.error != ParseError::None)
+            {
+               result.position = position;
+               return result;
+            }
+
+            baseValues[result.count] = Parsing::ToBase(*lastRecord, value);
+            ++result.count;
+         }
+         position = end + 1;
+      }
+      result.position = column.size();
+      return result;
+   }
+} //end namespace Units
+
+#endif  // UNITPARSE_CPP_GUARD
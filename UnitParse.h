@@ -0,0 +1,91 @@
+#ifndef UNITPARSE_H_GUARD
+#define UNITPARSE_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include "UnitRegistry.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace Units
+{
+   enum class ParseError : std::uint8_t
+   {
+      None,
+      InvalidNumber,    // no number at the start of the field
+      MissingUnit,      // a number with no suffix
+      UnknownUnit,      // a suffix no registered unit has
+      WrongDimension,   // a unit of another dimension than the one expected
+      OutputTooSmall    // more fields in a column than output values
+   };
+
+   // Outcome of parsing a column, count values were written and position is
+   // the offset of the first field that failed
+   struct ParseResult
+   {
+      ParseError error;
+      std::size_t count;
+      std::size_t position;
+   };
+
+   // Parses "<number><suffix>" with optional blanks around and between the
+   // two, e.g. "12.5nmi", "-40degF", "3.4e2 kPa". The number is read with
+   // std::from_chars (locale independent, no allocation) and the suffix is the
+   // user literal of a registered unit. On success value is in that unit's
+   // base unit. Never throws.
+   UNITS_INLINE ParseError ParseQuantity(std::string_view text, double& baseValue, UnitId& unit);
+
+   // As above, failing with WrongDimension unless the unit is of dimension
+   UNITS_INLINE ParseError ParseQuantity(std::string_view text, DimensionId dimension, double& baseValue);
+
+   // Parses every field of a column buffer separated by separator ('\n' for
+   // one value per line, blank fields skipped) into base values of dimension
+   UNITS_INLINE ParseResult ParseColumn(std::string_view column, char separator, DimensionId dimension, std::span<double> baseValues);
+
+   // Units::Length altitude;
+   // if (Units::Parse("35000ft", altitude) == Units::ParseError::None) ...
+   template <class QuantityType>
+   ParseError Parse(std::string_view text, QuantityType& result)
+   {
+      static_assert(StoredAsDouble<QuantityType>, "quantities are laid out as a double");
+      double baseValue = 0.0;
+      const ParseError error = ParseQuantity(text, DimensionIdOf<QuantityType>, baseValue);
+      if (error == ParseError::None)
+      {
+         // Every unit type is laid out as its base unit double (UNIT_LAYOUT_CHECKS)
+         result = std::bit_cast<QuantityType>(baseValue);
+      }
+      return error;
+   }
+
+   template <class QuantityType>
+   ParseResult ParseColumn(std::string_view column, std::span<QuantityType> output, char separator = '\n')
+   {
+      static_assert(StoredAsDouble<QuantityType> && (sizeof(QuantityType) == sizeof(double)), "quantities are laid out as a double");
+      const std::span<double> baseValues(reinterpret_cast<double*>(output.data()), output.size());
+      return ParseColumn(column, separator, DimensionIdOf<QuantityType>, baseValues);
+   }
+} //end namespace Units
+
+#ifdef UNITS_HEADER_ONLY
+#include "UnitParse.cpp"
+#endif
+
+#endif  // UNITPARSE_H_GUARD
@@ -0,0 +1,68 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#ifndef UNITREGISTRY_CPP_GUARD
+#define UNITREGISTRY_CPP_GUARD
+
+#include "UnitRegistry.h"
+#include <cmath>
+
+namespace Units
+{
+   UNITS_INLINE void convert(std::span<const double> input, std::span<double> output, UnitId from, UnitId to)
+   {
+      if (output.size() < input.size())
+      {
+         throw std::invalid_argument("Units::convert output is smaller than input");
+      }
+      if (!IsValid(from) || !IsValid(to) || (GetUnitRecord(from).dimension != GetUnitRecord(to).dimension))
+      {
+         throw std::invalid_argument("Units::convert units are not of one dimension");
+      }
+
+      const UnitConversion& conversion = GetUnitConversion(from, to);
+      const UnitRecord& fromRecord = GetUnitRecord(from);
+      const UnitRecord& toRecord = GetUnitRecord(to);
+      const bool fromLinear = fromRecord.affine && (fromRecord.offset == 0.0);
+      const bool toLinear = toRecord.affine && (toRecord.offset == 0.0);
+      if (conversion.affine)
+      {
+         ScaleOffset(input, output, conversion.factor, conversion.offset);
+      }
+      else if (fromRecord.decibel && toLinear)
+      {
+         DecibelsToRatio(input, output, fromRecord.reference / toRecord.scale);
+      }
+      else if (fromLinear && toRecord.decibel)
+      {
+         RatioToDecibels(input, output, fromRecord.scale / toRecord.reference);
+      }
+      else if (fromRecord.decibel && toRecord.decibel)
+      {
+         ScaleOffset(input, output, 1.0, 10.0 * std::log10(fromRecord.reference / toRecord.reference));
+      }
+      else
+      {
+         const std::size_t count = input.size();
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            output[i] = toRecord.FromBase(fromRecord.ToBase(input[i]));
+         }
+      }
+   }
+} //end namespace Units
+
+#endif  // UNITREGISTRY_CPP_GUARD
@@ -0,0 +1,504 @@
+#ifndef UNITREGISTRY_H_GUARD
+#define UNITREGISTRY_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include "UnitConvert.h"
+#include "AccelerationType.h"
+#include "AngleType.h"
+#include "AngularAccelerationType.h"
+#include "AngularSpeedType.h"
+#include "AreaType.h"
+#include "DensityType.h"
+#include "EnergyType.h"
+#include "ForceType.h"
+#include "LengthType.h"
+#include "MassType.h"
+#include "PowerType.h"
+#include "PressureType.h"
+#include "SpeedType.h"
+#include "TemperatureType.h"
+#include "TimeType.h"
+#include "VolumeType.h"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+namespace Units
+{
+   // Dense id of a registered unit, its position in Registry::RegisteredUnits.
+   // Ids depend on the order of that list, store suffixes rather than ids.
+   enum class UnitId : std::uint16_t
+   {
+      Invalid = 0xFFFF
+   };
+
+   // Dense id of a dimension, in order of first use in Registry::RegisteredUnits
+   using DimensionId = std::uint16_t;
+   inline constexpr DimensionId INVALID_DIMENSION = 0xFFFF;
+
+   // A registered unit as described by the traits of its UNIT_TEMPLATE macro
+   struct UnitRecord
+   {
+      std::string_view suffix;
+      DimensionId dimension;
+      std::uint16_t indexInDimension;
+      bool affine;
+      double scale;                    // base = (value * scale) + offset for affine units
+      double offset;
+      std::intmax_t ratioNumerator;    // exact ratio of UNIT_TEMPLATE_RATIO units, 0 otherwise
+      std::intmax_t ratioDenominator;
+      bool decibel;                    // base = reference * 10^(value / 10) for decibel units
+      double reference;
+      double (*ToBase)(double value);
+      double (*FromBase)(double base);
+   };
+
+   // to = (from * factor) + offset between two affine units of a dimension,
+   // otherwise the conversion goes through the base unit
+   struct UnitConversion
+   {
+      double factor;
+      double offset;
+      bool affine;
+   };
+
+   namespace Registry
+   {
+      template <class... Registered>
+      struct UnitList
+      {
+      };
+
+      // Every unit the runtime lookups know about. Units declared with the
+      // UNIT_TEMPLATE macros carry everything the registry needs, adding one
+      // here is all it takes to make it available by suffix. The
+      // registry_coverage test fails for a unit left out.
+      using RegisteredUnits = UnitList<
+         // AccelerationType.h
+         StandardGravity, MetersPerHourSquared, FeetPerMinuteSquared, FeetPerSecondSquared, MilesPerHourSquared,
+         KilometersPerHourSquared, InchesPerSecondSquared, Galileo, MetersPerSecondSquared,
+         // AngleType.h
+         Degrees, Radians, Milliradians, BAMS, Revolution, ArcMinute, ArcSecond,
+         // AngularAccelerationType.h
+         DegreesPerSecondSquared, DegreesPerMinuteSquared, DegreesPerHourSquared, RadiansPerSecondSquared,
+         MilliradiansPerSecondSquared, BAMS_PerSecondSquared, RevolutionPerSecondSquared, RevolutionPerMinuteSquared,
+         RevolutionPerHourSquared,
+         // AngularSpeedType.h
+         DegreesPerSecond, DegreesPerMinute, DegreesPerHour, RadiansPerSecond, MilliradiansPerSecond, BAMS_PerSecond,
+         RevolutionPerSecond, RevolutionPerMinute, RevolutionPerHour,
+         // AreaType.h
+         Hectare, SquareFeet, SquareInches, SquareGigameters, SquareMegameters, SquareKilometers, SquareHectometers,
+         SquareDecameters, SquareMeters, SquareDecimeters, SquareCentimeters, SquareMillimeters, SquareMicrometers,
+         SquareNanometers, SquarePicometers,
+         // DensityType.h
+         KilogramsPerCubicMeter, KilogramsPerLiter, GramsPerCubicCentimeter, GramsPerMilliliter, TonnesPerCubicMeter,
+         // EnergyType.h
+         WattHours, KilowattHours, Calories, Kilocalories, BritishThermalUnits, FootPounds, ElectronVolts, GigaJoules,
+         MegaJoules, KiloJoules, Joules, MilliJoules,
+         // ForceType.h
+         Newton, Dyne, KilogramsForce, PoundsForce,
+         // LengthType.h
+         FlightLevel, AstronomicalUnits, DataMiles, NauticalMiles, Miles, Leagues, Fathoms, Furlong, Yards, KiloFeet,
+         Feet, US_Survey_Feet, Inches, Gigameters, Megameters, Kilometers, Hectometers, Decameters, Meters, Decimeters,
+         Centimeters, Millimeters, Micrometers, Nanometers, Picometers,
+         // MassType.h
+         Grain, Pound, Ounce, Stone, ShortTon, LongTon, Tonne, Gigagrams, Megagrams, Kilograms, Hectograms, Decagrams,
+         Grams, Decigrams, Centigrams, Milligrams, Micrograms, Nanograms, Picograms,
+         // PowerType.h
+         HorsePower, decibelWatts, decibelMilliwatts, GigaWatts, MegaWatts, KiloWatts, HectoWatts, DecaWatts, Watts,
+         DeciWatts, CentiWatts, MilliWatts, MicroWatts, NanoWatts, PicoWatts,
+         // PressureType.h
+         Atmospheres, TechnicalAtmospheres, Bars, PoundsPerSquareInch, Torr, MillimetersMercury, GigaPascals,
+         MegaPascals, KiloPascals, HectoPascals, DecaPascals, Pascals, DeciPascals, CentiPascals, MilliPascals,
+         MicroPascals, NanoPascals, PicoPascals,
+         // SpeedType.h
+         Mach, Knots, MetersPerHour, FeetPerMinute, FeetPerSecond, MilesPerHour, KilometersPerHour, MetersPerSecond,
+         WarpFactor,
+         // TemperatureType.h
+         Kelvin, Celsius, Farenheit, Rankine,
+         // TimeType.h
+         LeapYears, NonLeapYears, Years, NonLeapYearMonths, Months, Weeks, Days, Hours, Minutes, Seconds, Milliseconds,
+         Microseconds, Nanoseconds, Picoseconds,
+         // VolumeType.h
+         Gallons, ImperialGallons, Quart, Pint, FluidOunces, Fifth, CubicMeters, CubicCentimeters, CubicYard,
+         CubicInches, Gigaliters, Megaliters, Kiloliters, Hectoliters, Decaliters, Liters, Deciliters, Centiliters,
+         Milliliters, Microliters, Nanoliters, Picoliters>;
+
+      using DimensionKey = std::array<int, 5>;
+
+      template <class Unit>
+      constexpr DimensionKey KeyOf()
+      {
+         using Dim = typename Unit::dimension;
+         return DimensionKey{ Dim::length, Dim::mass, Dim::time, Dim::temperature, Dim::angle };
+      }
+
+      template <class Unit>
+      constexpr UnitRecord MakeRecord()
+      {
+         using Base = Quantity<typename Unit::dimension>;
+
+         UnitRecord record{};
+         record.suffix = Unit::suffix;
+         record.affine = Unit::affine;
+         if constexpr (Unit::affine)
+         {
+            record.scale = Unit::scale;
+            record.offset = Unit::offset;
+         }
+         if constexpr (requires { typename Unit::exact_ratio; })
+         {
+            record.ratioNumerator = Unit::exact_ratio::num;
+            record.ratioDenominator = Unit::exact_ratio::den;
+         }
+         if constexpr (DecibelUnit<Unit>)
+         {
+            record.decibel = true;
+            record.reference = Unit::reference;
+         }
+         // Every unit type is laid out as its base unit double (UNIT_LAYOUT_CHECKS)
+         record.ToBase = [](double value) { return std::bit_cast<double>(Unit(value)); };
+         record.FromBase = [](double base) { return Unit(std::bit_cast<Base>(base)).value(); };
+         return record;
+      }
+
+      template <class... Registered>
+      constexpr std::array<DimensionKey, sizeof...(Registered)> MakeKeys(UnitList<Registered...>)
+      {
+         return { KeyOf<Registered>()... };
+      }
+
+      inline constexpr auto UNIT_KEYS = MakeKeys(RegisteredUnits{});
+      inline constexpr std::size_t UNIT_COUNT = UNIT_KEYS.size();
+
+      // Dimensions in order of first use
+      struct DimensionList
+      {
+         std::array<DimensionKey, UNIT_COUNT> keys;
+         std::size_t count;
+      };
+
+      constexpr DimensionList MakeDimensionList()
+      {
+         DimensionList dimensions{};
+         for (const DimensionKey& key : UNIT_KEYS)
+         {
+            bool seen = false;
+            for (std::size_t i = 0; !seen && (i < dimensions.count); ++i)
+            {
+               seen = (dimensions.keys[i] == key);
+            }
+            if (!seen)
+            {
+               dimensions.keys[dimensions.count++] = key;
+            }
+         }
+         return dimensions;
+      }
+
+      inline constexpr DimensionList DIMENSIONS = MakeDimensionList();
+      inline constexpr std::size_t DIMENSION_COUNT = DIMENSIONS.count;
+
+      constexpr DimensionId FindDimension(const DimensionKey& key)
+      {
+         for (std::size_t i = 0; i < DIMENSION_COUNT; ++i)
+         {
+            if (DIMENSIONS.keys[i] == key)
+            {
+               return DimensionId(i);
+            }
+         }
+         return INVALID_DIMENSION;
+      }
+
+      template <class... Registered>
+      constexpr std::array<UnitRecord, sizeof...(Registered)> MakeRecords(UnitList<Registered...>)
+      {
+         std::array<UnitRecord, sizeof...(Registered)> records{ MakeRecord<Registered>()... };
+         std::array<std::uint16_t, DIMENSION_COUNT> unitsSoFar{};
+         for (std::size_t i = 0; i < records.size(); ++i)
+         {
+            records[i].dimension = FindDimension(UNIT_KEYS[i]);
+            records[i].indexInDimension = unitsSoFar[records[i].dimension]++;
+         }
+         return records;
+      }
+
+      inline constexpr auto UNIT_RECORDS = MakeRecords(RegisteredUnits{});
+
+      // Each dimension has a square block of the conversion matrix, rows are
+      // the unit converted from and columns the unit converted to
+      struct MatrixLayout
+      {
+         std::array<std::size_t, DIMENSION_COUNT> units;
+         std::array<std::size_t, DIMENSION_COUNT> first;    // units of earlier dimensions
+         std::array<std::size_t, DIMENSION_COUNT> offset;   // start of the block
+         std::size_t size;
+      };
+
+      constexpr MatrixLayout MakeMatrixLayout()
+      {
+         MatrixLayout layout{};
+         for (const UnitRecord& record : UNIT_RECORDS)
+         {
+            ++layout.units[record.dimension];
+         }
+         std::size_t first = 0;
+         for (std::size_t dimension = 0; dimension < DIMENSION_COUNT; ++dimension)
+         {
+            layout.first[dimension] = first;
+            layout.offset[dimension] = layout.size;
+            first += layout.units[dimension];
+            layout.size += layout.units[dimension] * layout.units[dimension];
+         }
+         return layout;
+      }
+
+      inline constexpr MatrixLayout MATRIX_LAYOUT = MakeMatrixLayout();
+
+      // Same factors Units::Conversion folds for the two unit types
+      constexpr UnitConversion MakeConversion(const UnitRecord& from, const UnitRecord& to)
+      {
+         UnitConversion conversion{ 1.0, 0.0, from.affine && to.affine };
+         if (conversion.affine)
+         {
+            const bool exact = (from.ratioNumerator != 0) && (to.ratioNumerator != 0);
+            conversion.factor = exact ? RatioQuotient(from.ratioNumerator, from.ratioDenominator, to.ratioNumerator, to.ratioDenominator, from.scale / to.scale)
+               : (from.scale / to.scale);
+            conversion.offset = (from.offset - to.offset) / to.scale;
+         }
+         return conversion;
+      }
+
+      constexpr std::array<UnitConversion, MATRIX_LAYOUT.size> MakeMatrix()
+      {
+         // Units grouped by dimension, in the order of their index in it
+         std::array<std::size_t, UNIT_COUNT> grouped{};
+         for (std::size_t unit = 0; unit < UNIT_COUNT; ++unit)
+         {
+            const UnitRecord& record = UNIT_RECORDS[unit];
+            const std::size_t firstOfDimension = MATRIX_LAYOUT.first[record.dimension];
+            grouped[firstOfDimension + record.indexInDimension] = unit;
+         }
+
+         std::array<UnitConversion, MATRIX_LAYOUT.size> matrix{};
+         for (std::size_t dimension = 0; dimension < DIMENSION_COUNT; ++dimension)
+         {
+            const std::size_t units = MATRIX_LAYOUT.units[dimension];
+            const std::size_t first = MATRIX_LAYOUT.first[dimension];
+            for (std::size_t from = 0; from < units; ++from)
+            {
+               for (std::size_t to = 0; to < units; ++to)
+               {
+                  matrix[MATRIX_LAYOUT.offset[dimension] + (from * units) + to] = MakeConversion(UNIT_RECORDS[grouped[first + from]], UNIT_RECORDS[grouped[first + to]]);
+               }
+            }
+         }
+         return matrix;
+      }
+
+      inline constexpr auto CONVERSION_MATRIX = MakeMatrix();
+
+      // Perfect hash of the suffixes (hash and displace): the first hash picks
+      // a bucket, each bucket stores the seed of a second hash that sends its
+      // suffixes to slots no other suffix uses, found here at compile time
+      inline constexpr std::size_t HASH_BUCKETS = std::bit_ceil(UNIT_COUNT / 4 + 1);
+      inline constexpr std::size_t HASH_SLOTS = std::bit_ceil(UNIT_COUNT * 2);
+      inline constexpr std::uint16_t EMPTY_SLOT = 0xFFFF;
+
+      // FNV-1a with a final mix so the low bits depend on every character
+      constexpr std::uint32_t SuffixHash(std::string_view suffix, std::uint32_t seed)
+      {
+         std::uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+         for (char character : suffix)
+         {
+            hash ^= std::uint8_t(character);
+            hash *= 16777619u;
+         }
+         hash ^= hash >> 15;
+         hash *= 0x2C1B3C6Du;
+         hash ^= hash >> 12;
+         return hash;
+      }
+
+      struct SuffixTable
+      {
+         std::array<std::uint16_t, HASH_BUCKETS> seeds;
+         std::array<std::uint16_t, HASH_SLOTS> units;
+      };
+
+      constexpr SuffixTable MakeSuffixTable()
+      {
+         SuffixTable table{};
+         table.units.fill(EMPTY_SLOT);
+
+         std::array<std::size_t, UNIT_COUNT> bucketOf{};
+         std::array<std::size_t, HASH_BUCKETS> bucketSize{};
+         for (std::size_t unit = 0; unit < UNIT_COUNT; ++unit)
+         {
+            bucketOf[unit] = SuffixHash(UNIT_RECORDS[unit].suffix, 0) & (HASH_BUCKETS - 1);
+            ++bucketSize[bucketOf[unit]];
+         }
+
+         // Largest buckets first while most slots are free
+         std::array<std::size_t, HASH_BUCKETS> order{};
+         for (std::size_t bucket = 0; bucket < HASH_BUCKETS; ++bucket)
+         {
+            order[bucket] = bucket;
+         }
+         for (std::size_t i = 0; i < HASH_BUCKETS; ++i)
+         {
+            for (std::size_t j = i + 1; j < HASH_BUCKETS; ++j)
+            {
+               if (bucketSize[order[j]] > bucketSize[order[i]])
+               {
+                  const std::size_t swap = order[i];
+                  order[i] = order[j];
+                  order[j] = swap;
+               }
+            }
+         }
+
+         for (const std::size_t bucket : order)
+         {
+            std::array<std::size_t, UNIT_COUNT> members{};
+            std::size_t memberCount = 0;
+            for (std::size_t unit = 0; unit < UNIT_COUNT; ++unit)
+            {
+               if (bucketOf[unit] == bucket)
+               {
+                  members[memberCount++] = unit;
+               }
+            }
+
+            bool placed = (memberCount == 0);
+            std::array<std::size_t, UNIT_COUNT> slots{};
+            for (std::uint32_t seed = 1; !placed && (seed < EMPTY_SLOT); ++seed)
+            {
+               placed = true;
+               for (std::size_t i = 0; placed && (i < memberCount); ++i)
+               {
+                  slots[i] = SuffixHash(UNIT_RECORDS[members[i]].suffix, seed) & (HASH_SLOTS - 1);
+                  placed = (table.units[slots[i]] == EMPTY_SLOT);
+                  for (std::size_t j = 0; placed && (j < i); ++j)
+                  {
+                     placed = (slots[j] != slots[i]);
+                  }
+               }
+               if (placed)
+               {
+                  table.seeds[bucket] = std::uint16_t(seed);
+               }
+            }
+            if (!placed)
+            {
+               throw std::logic_error("no perfect hash seed for a suffix bucket");
+            }
+            for (std::size_t i = 0; i < memberCount; ++i)
+            {
+               table.units[slots[i]] = std::uint16_t(members[i]);
+            }
+         }
+         return table;
+      }
+
+      inline constexpr SuffixTable SUFFIX_TABLE = MakeSuffixTable();
+
+      template <class Unit, class... Registered>
+      constexpr std::size_t IndexOf(UnitList<Registered...>)
+      {
+         std::size_t index = 0;
+         const bool found = ((std::is_same_v<Unit, Registered> || (++index, false)) || ...);
+         return found ? index : std::size_t(UnitId::Invalid);
+      }
+   } //end namespace Registry
+
+   template <class Unit>
+   inline constexpr UnitId UnitIdOf = UnitId(Registry::IndexOf<Unit>(Registry::RegisteredUnits{}));
+
+   // Dimension of a quantity or unit type, INVALID_DIMENSION if no registered unit has it
+   template <class QuantityType>
+   inline constexpr DimensionId DimensionIdOf = Registry::FindDimension(Registry::KeyOf<QuantityType>());
+
+   // The unit with the literal suffix, "nmi" is NauticalMiles, or UnitId::Invalid
+   constexpr UnitId FindUnit(std::string_view suffix)
+   {
+      const std::size_t bucket = Registry::SuffixHash(suffix, 0) & (Registry::HASH_BUCKETS - 1);
+      const std::size_t slot = Registry::SuffixHash(suffix, Registry::SUFFIX_TABLE.seeds[bucket]) & (Registry::HASH_SLOTS - 1);
+      const std::uint16_t unit = Registry::SUFFIX_TABLE.units[slot];
+
+      return ((unit != Registry::EMPTY_SLOT) && (Registry::UNIT_RECORDS[unit].suffix == suffix)) ? UnitId(unit) : UnitId::Invalid;
+   }
+
+   constexpr const UnitRecord& GetUnitRecord(UnitId unit)
+   {
+      return Registry::UNIT_RECORDS[std::size_t(unit)];
+   }
+
+   constexpr bool IsValid(UnitId unit)
+   {
+      return std::size_t(unit) < Registry::UNIT_COUNT;
+   }
+
+   // Matrix entry converting between two units of one dimension
+   constexpr const UnitConversion& GetUnitConversion(UnitId from, UnitId to)
+   {
+      const UnitRecord& fromRecord = GetUnitRecord(from);
+      const UnitRecord& toRecord = GetUnitRecord(to);
+      const std::size_t units = Registry::MATRIX_LAYOUT.units[fromRecord.dimension];
+      return Registry::CONVERSION_MATRIX[Registry::MATRIX_LAYOUT.offset[fromRecord.dimension] + (fromRecord.indexInDimension * units) + toRecord.indexInDimension];
+   }
+
+   // Runtime counterpart of Units::convert<From, To>, giving the same bits.
+   // Throws std::invalid_argument for invalid ids or units of different dimensions.
+   inline double convert(double value, UnitId from, UnitId to)
+   {
+      if (!IsValid(from) || !IsValid(to) || (GetUnitRecord(from).dimension != GetUnitRecord(to).dimension))
+      {
+         throw std::invalid_argument("Units::convert units are not of one dimension");
+      }
+
+      const UnitConversion& conversion = GetUnitConversion(from, to);
+      if (!conversion.affine)
+      {
+         return GetUnitRecord(to).FromBase(GetUnitRecord(from).ToBase(value));
+      }
+      if (conversion.offset == 0.0)
+      {
+         return value * conversion.factor;
+      }
+      return (value * conversion.factor) + conversion.offset;
+   }
+
+   // Converts every value of input into output on the batch kernels, as the
+   // compile time span convert does at Strict precision. Affine conversions
+   // match the scalar convert bit for bit, decibel to linear and linear to
+   // decibel run on the logarithmic kernels within a few ULP of it. Other
+   // units convert one value at a time through the base unit.
+   UNITS_INLINE void convert(std::span<const double> input, std::span<double> output, UnitId from, UnitId to);
+} //end namespace Units
+
+#ifdef UNITS_HEADER_ONLY
+#include "UnitRegistry.cpp"
+#endif
+
+#endif  // UNITREGISTRY_H_GUARD
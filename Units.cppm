@@ -0,0 +1,78 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+// The Units named module, exports everything declared by Units.h
+//
+//    import Units;
+//
+// The definitions come from the compiled library, so the module is built
+// and linked with the .cpp files and without UNITS_HEADER_ONLY. Every system
+// header the library includes is listed in the global module fragment, which
+// keeps the standard library out of the module and turns the includes inside
+// the export block into no-ops.
+
+module;
+
+// The TBB backend of <execution> has internal linkage helpers that a module
+// cannot expose, the library only uses the policy types
+#define _GLIBCXX_USE_TBB_PAR_BACKEND 0
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <execution>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <ranges>
+#include <ratio>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <version>
+#ifdef __cpp_lib_format
+#include <format>
+#endif
+
+#ifdef UNITS_HEADER_ONLY
+#error "Units.cppm is built against the compiled library, not UNITS_HEADER_ONLY"
+#endif
+
+export module Units;
+
+export
+{
+#include "Units.h"
+}
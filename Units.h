@@ -0,0 +1,59 @@
+#ifndef UNITS_H_GUARD
+#define UNITS_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+
+// Every dimension and unit with the registry, parsing, formatting, arrays,
+// files, FixedPoint, the thread pool and its execution policies, for a
+// precompiled header or a single include. Units.cppm exports the same
+// declarations as the Units module.
+
+#include "UnitBase.h"
+#include "UnitBatch.h"
+#include "UnitConvert.h"
+#include "AccelerationType.h"
+#include "AngleType.h"
+#include "AngularAccelerationType.h"
+#include "AngularSpeedType.h"
+#include "AreaType.h"
+#include "DensityType.h"
+#include "EnergyType.h"
+#include "ForceType.h"
+#include "LengthType.h"
+#include "MassType.h"
+#include "PowerType.h"
+#include "PressureType.h"
+#include "SpeedType.h"
+#include "TemperatureType.h"
+#include "TimeType.h"
+#include "VolumeType.h"
+#include "Constants.h"
+#include "FixedPoint.h"
+#include "BinaryAngle.h"
+#include "AngleMath.h"
+#include "Vec3.h"
+#include "Kinematics.h"
+#include "Calculus.h"
+#include "UnitRegistry.h"
+#include "UnitParse.h"
+#include "UnitFormat.h"
+#include "QuantityArray.h"
+#include "QuantityFile.h"
+#include "UnitParallel.h"
+#include "UnitExecution.h"
+
+#endif  // UNITS_H_GUARD
@@ -0,0 +1,394 @@
+#ifndef VEC3_H_GUARD
+#define VEC3_H_GUARD
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+#include "UnitBase.h"
+#include "ArrayExpression.h"
+#include "QuantityArray.h"
+#include "UnitBatch.h"
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+namespace Units
+{
+   namespace Vectors
+   {
+      // The base quantity of a scalar operand, Meters becomes a Length
+      template <class T>
+      struct ScalarOf
+      {
+      };
+      template <>
+      struct ScalarOf<double>
+      {
+         using type = double;
+      };
+      template <class T>
+         requires std::is_base_of_v<Quantity<typename T::dimension>, T>
+      struct ScalarOf<T>
+      {
+         using type = Quantity<typename T::dimension>;
+      };
+
+      template <class T>
+      using Scalar = typename ScalarOf<std::remove_cvref_t<T>>::type;
+
+      // A single quantity or double
+      template <class T>
+      concept ScalarOperand = requires { typename Scalar<T>; };
+
+      // Every unit type is laid out as its base unit double (UNIT_LAYOUT_CHECKS)
+      template <class Element>
+      constexpr double BaseOf(const Element& value)
+      {
+         return std::bit_cast<double>(value);
+      }
+
+      // Reaches the base unit constructor the way unit types do (bit_cast
+      // into a quantity is not a constant expression on GCC 12)
+      template <class Element>
+      struct BaseUnit : Element
+      {
+         constexpr explicit BaseUnit(double value) : Element(value) {}
+      };
+      template <class Element>
+      constexpr Element FromBase(double value)
+      {
+         if constexpr (std::is_same_v<Element, double>)
+         {
+            return value;
+         }
+         else
+         {
+            return BaseUnit<Element>(value);
+         }
+      }
+   } //end namespace Vectors
+
+   // Three components of one quantity, Vec3<Speed> is a velocity. The
+   // components are contiguous base unit doubles with no padding, so arrays
+   // of Vec3 are plain arrays of doubles. Arithmetic follows the scalar
+   // dimension rules component by component, working on the base unit
+   // doubles inline:
+   //    Vec3<Length> displacement = velocity * Seconds(0.1);
+   //    Area along = Dot(displacement, heading);
+   // Element is a base quantity such as Length, or double for
+   // dimensionless vectors.
+   template <class Element>
+   struct Vec3
+   {
+      static_assert(std::is_same_v<Vectors::Scalar<Element>, Element>, "Vec3 components are base quantities such as Length, or double");
+
+      using value_type = Element;
+
+      Element x{};
+      Element y{};
+      Element z{};
+
+      constexpr Vec3& operator+=(const Vec3& rhs)
+      {
+         x += rhs.x;
+         y += rhs.y;
+         z += rhs.z;
+         return *this;
+      }
+      constexpr Vec3& operator-=(const Vec3& rhs)
+      {
+         x -= rhs.x;
+         y -= rhs.y;
+         z -= rhs.z;
+         return *this;
+      }
+
+      constexpr bool operator==(const Vec3& rhs) const = default;
+   };
+
+   template <class Element>
+   constexpr Vec3<Element> operator+(const Vec3<Element>& lhs, const Vec3<Element>& rhs)
+   {
+      return { lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z };
+   }
+   template <class Element>
+   constexpr Vec3<Element> operator-(const Vec3<Element>& lhs, const Vec3<Element>& rhs)
+   {
+      return { lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z };
+   }
+   template <class Element>
+   constexpr Vec3<Element> operator-(const Vec3<Element>& vector)
+   {
+      return { -vector.x, -vector.y, -vector.z };
+   }
+
+   // Every component scaled by a quantity or double, Vec3<Speed> * Time is a
+   // Vec3<Length>
+   template <class Element, Vectors::ScalarOperand Rhs>
+   constexpr auto operator*(const Vec3<Element>& lhs, const Rhs& rhs)
+   {
+      using Result = typename ArrayExpressions::ProductOf<Element, Vectors::Scalar<Rhs>>::type;
+      const double scale = Vectors::BaseOf(Vectors::Scalar<Rhs>(rhs));
+      return Vec3<Result>{ Vectors::FromBase<Result>(Vectors::BaseOf(lhs.x) * scale),
+         Vectors::FromBase<Result>(Vectors::BaseOf(lhs.y) * scale),
+         Vectors::FromBase<Result>(Vectors::BaseOf(lhs.z) * scale) };
+   }
+   template <Vectors::ScalarOperand Lhs, class Element>
+   constexpr auto operator*(const Lhs& lhs, const Vec3<Element>& rhs)
+   {
+      return rhs * lhs;
+   }
+   template <class Element, Vectors::ScalarOperand Rhs>
+   constexpr auto operator/(const Vec3<Element>& lhs, const Rhs& rhs)
+   {
+      using Result = typename ArrayExpressions::QuotientOf<Element, Vectors::Scalar<Rhs>>::type;
+      const double divisor = Vectors::BaseOf(Vectors::Scalar<Rhs>(rhs));
+      return Vec3<Result>{ Vectors::FromBase<Result>(Vectors::BaseOf(lhs.x) / divisor),
+         Vectors::FromBase<Result>(Vectors::BaseOf(lhs.y) / divisor),
+         Vectors::FromBase<Result>(Vectors::BaseOf(lhs.z) / divisor) };
+   }
+
+   // Dot(Vec3<Length>, Vec3<Length>) is an Area, Dot(Vec3<Force>, Vec3<Length>) an Energy
+   template <class Lhs, class Rhs>
+   constexpr auto Dot(const Vec3<Lhs>& lhs, const Vec3<Rhs>& rhs)
+   {
+      using Result = typename ArrayExpressions::ProductOf<Lhs, Rhs>::type;
+      return Vectors::FromBase<Result>((Vectors::BaseOf(lhs.x) * Vectors::BaseOf(rhs.x)) +
+         (Vectors::BaseOf(lhs.y) * Vectors::BaseOf(rhs.y)) + (Vectors::BaseOf(lhs.z) * Vectors::BaseOf(rhs.z)));
+   }
+
+   // Cross(Vec3<Length>, Vec3<Force>) is a torque as a Vec3<Energy>
+   template <class Lhs, class Rhs>
+   constexpr auto Cross(const Vec3<Lhs>& lhs, const Vec3<Rhs>& rhs)
+   {
+      using Result = typename ArrayExpressions::ProductOf<Lhs, Rhs>::type;
+      const double lx = Vectors::BaseOf(lhs.x);
+      const double ly = Vectors::BaseOf(lhs.y);
+      const double lz = Vectors::BaseOf(lhs.z);
+      const double rx = Vectors::BaseOf(rhs.x);
+      const double ry = Vectors::BaseOf(rhs.y);
+      const double rz = Vectors::BaseOf(rhs.z);
+      return Vec3<Result>{ Vectors::FromBase<Result>((ly * rz) - (lz * ry)),
+         Vectors::FromBase<Result>((lz * rx) - (lx * rz)),
+         Vectors::FromBase<Result>((lx * ry) - (ly * rx)) };
+   }
+
+   // Length of the vector in its own dimension, Norm(Vec3<Speed>) is a Speed
+   template <class Element>
+   Element Norm(const Vec3<Element>& vector)
+   {
+      return Vectors::FromBase<Element>(std::sqrt(Vectors::BaseOf(Dot(vector, vector))));
+   }
+
+   // Unit vector in the direction of vector, NaN components for a zero vector
+   template <class Element>
+   Vec3<double> Normalized(const Vec3<Element>& vector)
+   {
+      const double norm = Vectors::BaseOf(Norm(vector));
+      return { Vectors::BaseOf(vector.x) / norm, Vectors::BaseOf(vector.y) / norm, Vectors::BaseOf(vector.z) / norm };
+   }
+
+   // Many vectors as a structure of arrays, each component in its own
+   // aligned QuantityArray so a loop over the vectors runs whole SIMD
+   // registers of x, then y, then z. Arithmetic builds the same lazy
+   // expressions as QuantityArray, one per component, evaluated when assigned:
+   //    position += velocity * frameTime;                  // Vec3Array<Length>, Vec3Array<Speed>, Time
+   //    QuantityArray<Area> along = Dot(position, heading);
+   template <class Element>
+   class Vec3Array
+   {
+   public:
+      using value_type = Vec3<Element>;
+      static constexpr bool vec3_batch = true;
+
+      Vec3Array() = default;
+      explicit Vec3Array(std::size_t size, ArrayMemory memory = ArrayMemory::Aligned) : x(size, memory), y(size, memory), z(size, memory) {}
+
+      // Evaluates a vector expression, one pass per component
+      template <class Expression>
+         requires (std::remove_cvref_t<Expression>::vec3_batch && ArrayExpressionOf<decltype(Expression::x), Element>)
+      Vec3Array(const Expression& expression, ArrayMemory memory = ArrayMemory::Aligned)
+         : x(expression.x, memory), y(expression.y, memory), z(expression.z, memory)
+      {
+      }
+      // One pass over the vectors, all three components of a vector are
+      // evaluated before any is written, so the expression may read this
+      // array, e.g. a = Cross(a, b)
+      template <class Expression>
+         requires (std::remove_cvref_t<Expression>::vec3_batch && ArrayExpressionOf<decltype(Expression::x), Element>)
+      Vec3Array& operator=(const Expression& expression)
+      {
+         if (expression.size() != size())
+         {
+            return *this = Vec3Array(expression, x.Memory());
+         }
+         const auto xOperand = ArrayExpressions::OperandOf<std::remove_cvref_t<decltype(expression.x)>>::Make(expression.x);
+         const auto yOperand = ArrayExpressions::OperandOf<std::remove_cvref_t<decltype(expression.y)>>::Make(expression.y);
+         const auto zOperand = ArrayExpressions::OperandOf<std::remove_cvref_t<decltype(expression.z)>>::Make(expression.z);
+         double* const xValues = x.Values().data();
+         double* const yValues = y.Values().data();
+         double* const zValues = z.Values().data();
+         const std::size_t count = size();
+         for (std::size_t i = 0; i < count; ++i)
+         {
+            const double xValue = xOperand.Evaluate(i);
+            const double yValue = yOperand.Evaluate(i);
+            const double zValue = zOperand.Evaluate(i);
+            xValues[i] = xValue;
+            yValues[i] = yValue;
+            zValues[i] = zValue;
+         }
+         return *this;
+      }
+
+      template <class Rhs>
+      Vec3Array& operator+=(const Rhs& rhs) { return *this = (*this + rhs); }
+      template <class Rhs>
+      Vec3Array& operator-=(const Rhs& rhs) { return *this = (*this - rhs); }
+
+      std::size_t size() const { return x.size(); }
+
+      Vec3<Element> operator[](std::size_t index) const { return { x[index], y[index], z[index] }; }
+      void Set(std::size_t index, const Vec3<Element>& value)
+      {
+         x[index] = value.x;
+         y[index] = value.y;
+         z[index] = value.z;
+      }
+
+      QuantityArray<Element> x;
+      QuantityArray<Element> y;
+      QuantityArray<Element> z;
+   };
+
+   namespace Vectors
+   {
+      // Lazy vector of three component expressions
+      template <class X, class Y, class Z>
+      struct Expression
+      {
+         static constexpr bool vec3_batch = true;
+
+         X x;
+         Y y;
+         Z z;
+
+         std::size_t size() const { return x.size(); }
+      };
+
+      template <class X, class Y, class Z>
+      Expression<X, Y, Z> MakeExpression(const X& x, const Y& y, const Z& z)
+      {
+         return { x, y, z };
+      }
+
+      template <class T>
+      concept Batch = requires { requires std::remove_cvref_t<T>::vec3_batch; };
+
+      template <class T>
+      inline constexpr bool IS_VEC3 = false;
+      template <class Element>
+      constexpr bool IS_VEC3<Vec3<Element>> = true;
+
+      template <class T>
+      concept Vector = Batch<T> || IS_VEC3<std::remove_cvref_t<T>>;
+
+      // Two vectors, at least one of them many vectors
+      template <class Lhs, class Rhs>
+      concept BatchOperands = Vector<Lhs> && Vector<Rhs> && (Batch<Lhs> || Batch<Rhs>);
+
+      // A vector and a per vector scalar (a quantity, double, QuantityArray
+      // or array expression), at least one of them many values
+      template <class VectorType, class ScalarType>
+      concept BatchScaling = Vector<VectorType> && !Vector<ScalarType> && requires { typename ArrayExpressions::Operand<ScalarType>; } &&
+         (Batch<VectorType> || !ArrayExpressions::Operand<ScalarType>::scalar);
+   } //end namespace Vectors
+
+   template <class Lhs, class Rhs>
+      requires Vectors::BatchOperands<Lhs, Rhs>
+   auto operator+(const Lhs& lhs, const Rhs& rhs)
+   {
+      return Vectors::MakeExpression(lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z);
+   }
+   template <class Lhs, class Rhs>
+      requires Vectors::BatchOperands<Lhs, Rhs>
+   auto operator-(const Lhs& lhs, const Rhs& rhs)
+   {
+      return Vectors::MakeExpression(lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z);
+   }
+   template <class Lhs, class Rhs>
+      requires Vectors::BatchScaling<Lhs, Rhs>
+   auto operator*(const Lhs& lhs, const Rhs& rhs)
+   {
+      return Vectors::MakeExpression(lhs.x * rhs, lhs.y * rhs, lhs.z * rhs);
+   }
+   template <class Lhs, class Rhs>
+      requires Vectors::BatchScaling<Rhs, Lhs>
+   auto operator*(const Lhs& lhs, const Rhs& rhs)
+   {
+      return Vectors::MakeExpression(lhs * rhs.x, lhs * rhs.y, lhs * rhs.z);
+   }
+   template <class Lhs, class Rhs>
+      requires Vectors::BatchScaling<Lhs, Rhs>
+   auto operator/(const Lhs& lhs, const Rhs& rhs)
+   {
+      return Vectors::MakeExpression(lhs.x / rhs, lhs.y / rhs, lhs.z / rhs);
+   }
+
+   // Per vector dot product as an array expression, assign it to a
+   // QuantityArray within the same statement
+   template <class Lhs, class Rhs>
+      requires Vectors::BatchOperands<Lhs, Rhs>
+   auto Dot(const Lhs& lhs, const Rhs& rhs)
+   {
+      return (lhs.x * rhs.x) + (lhs.y * rhs.y) + (lhs.z * rhs.z);
+   }
+   template <class Lhs, class Rhs>
+      requires Vectors::BatchOperands<Lhs, Rhs>
+   auto Cross(const Lhs& lhs, const Rhs& rhs)
+   {
+      return Vectors::MakeExpression((lhs.y * rhs.z) - (lhs.z * rhs.y), (lhs.z * rhs.x) - (lhs.x * rhs.z), (lhs.x * rhs.y) - (lhs.y * rhs.x));
+   }
+
+   // Norm of every vector on the SIMD kernels of UnitBatch.h
+   template <class Element>
+   QuantityArray<Element> Norm(const Vec3Array<Element>& vectors)
+   {
+      QuantityArray<Element> norms(vectors.size());
+      VectorNorms(vectors.x.Values(), vectors.y.Values(), vectors.z.Values(), norms.Values());
+      return norms;
+   }
+
+   // Norm of every vector of an expression, evaluated in one pass
+   template <class VectorType>
+      requires Vectors::Batch<VectorType>
+   auto Norm(const VectorType& vectors)
+   {
+      using Element = typename ArrayExpressions::Operand<decltype(VectorType::x)>::element_type;
+      const auto squares = Dot(vectors, vectors);
+      const auto operand = ArrayExpressions::OperandOf<std::remove_cvref_t<decltype(squares)>>::Make(squares);
+
+      QuantityArray<Element> norms(squares.size());
+      double* values = norms.Values().data();
+      for (std::size_t i = 0; i < norms.size(); ++i)
+      {
+         values[i] = std::sqrt(operand.Evaluate(i));
+      }
+      return norms;
+   }
+} //end namespace Units
+
+#endif  // VEC3_H_GUARD
@@ -21,42 +21,37 @@ limitations under the License.
 
 namespace Units
 {
-   class Area;
-   class Length;
+   // Base unit is cubic meters
+   using Volume = Quantity<Dimension<3, 0, 0, 0, 0>>;
 
-   class Volume
-   {
-   public:
-
-      Area operator/(const Length& length) const;
-
-      GENERIC_OPERATORS(Volume);
-   };
+   // Metric prefixes are relative to the liter, 1/1000 of the base unit
+   template <class Prefix>
+   using LiterPrefix = std::ratio_divide<Prefix, std::kilo>;
 } //end namespace Units
 
-UNIT_TEMPLATE(Volume, Gallons, 3.785411784, gal);
-UNIT_TEMPLATE(Volume, ImperialGallons, 4.54609, impgal);
-UNIT_TEMPLATE(Volume, Quart, (3.785411784 / 4.0), quart);
-UNIT_TEMPLATE(Volume, Pint, (3.785411784 / 8.0), pint);
-UNIT_TEMPLATE(Volume, FluidOunces, (3.785411784 / 128.0), floz);
-UNIT_TEMPLATE(Volume, Fifth, (3.785411784 / 5.0), fifth);
-UNIT_TEMPLATE(Volume, CubicMeters, (0.001), m3);
-UNIT_TEMPLATE(Volume, CubicCentimeters, (1000.0), cm3);
-UNIT_TEMPLATE(Volume, CubicYard, (0.00130795062), yd3);
-UNIT_TEMPLATE(Volume, CubicInches, (3.785411784 / 231.0), in3);
+UNIT_TEMPLATE(Volume, Gallons, 0.003785411784, gal);
+UNIT_TEMPLATE(Volume, ImperialGallons, 0.00454609, impgal);
+UNIT_TEMPLATE(Volume, Quart, (0.003785411784 / 4.0), quart);
+UNIT_TEMPLATE(Volume, Pint, (0.003785411784 / 8.0), pint);
+UNIT_TEMPLATE(Volume, FluidOunces, (0.003785411784 / 128.0), floz);
+UNIT_TEMPLATE(Volume, Fifth, (0.003785411784 / 5.0), fifth);
+UNIT_TEMPLATE_RATIO(Volume, CubicMeters, 1, 1, m3);
+UNIT_TEMPLATE_RATIO(Volume, CubicCentimeters, std::micro::num, std::micro::den, cm3);
+UNIT_TEMPLATE(Volume, CubicYard, (0.9144 * 0.9144 * 0.9144), yd3);
+UNIT_TEMPLATE(Volume, CubicInches, (0.003785411784 / 231.0), in3);
 
 //Metric
-UNIT_TEMPLATE(Volume, Gigaliters, (double(std::giga::num) / double(std::giga::den)), GL);
-UNIT_TEMPLATE(Volume, Megaliters, (double(std::mega::num) / double(std::mega::den)), ML);
-UNIT_TEMPLATE(Volume, Kiloliters, (double(std::kilo::num) / double(std::kilo::den)), kL);
-UNIT_TEMPLATE(Volume, Hectoliters, (double(std::hecto::num) / double(std::hecto::den)), HL);
-UNIT_TEMPLATE(Volume, Decaliters, (double(std::deca::num) / double(std::deca::den)), DL);
-UNIT_TEMPLATE(Volume, Liters, 1.0, L);
-UNIT_TEMPLATE(Volume, Deciliters, (double(std::deci::num) / double(std::deci::den)), dL);
-UNIT_TEMPLATE(Volume, Centiliters, (double(std::centi::num) / double(std::centi::den)), cL);
-UNIT_TEMPLATE(Volume, Milliliters, (double(std::milli::num) / double(std::milli::den)), mL);
-UNIT_TEMPLATE(Volume, Microliters, (double(std::micro::num) / double(std::micro::den)), uL);
-UNIT_TEMPLATE(Volume, Nanoliters, (double(std::nano::num) / double(std::nano::den)), nL);
-UNIT_TEMPLATE(Volume, Picoliters, (double(std::pico::num) / double(std::pico::den)), pL);
+UNIT_TEMPLATE_RATIO(Volume, Gigaliters, Units::LiterPrefix<std::giga>::num, Units::LiterPrefix<std::giga>::den, GL);
+UNIT_TEMPLATE_RATIO(Volume, Megaliters, Units::LiterPrefix<std::mega>::num, Units::LiterPrefix<std::mega>::den, ML);
+UNIT_TEMPLATE_RATIO(Volume, Kiloliters, Units::LiterPrefix<std::kilo>::num, Units::LiterPrefix<std::kilo>::den, kL);
+UNIT_TEMPLATE_RATIO(Volume, Hectoliters, Units::LiterPrefix<std::hecto>::num, Units::LiterPrefix<std::hecto>::den, HL);
+UNIT_TEMPLATE_RATIO(Volume, Decaliters, Units::LiterPrefix<std::deca>::num, Units::LiterPrefix<std::deca>::den, DL);
+UNIT_TEMPLATE_RATIO(Volume, Liters, std::milli::num, std::milli::den, L);
+UNIT_TEMPLATE_RATIO(Volume, Deciliters, Units::LiterPrefix<std::deci>::num, Units::LiterPrefix<std::deci>::den, dL);
+UNIT_TEMPLATE_RATIO(Volume, Centiliters, Units::LiterPrefix<std::centi>::num, Units::LiterPrefix<std::centi>::den, cL);
+UNIT_TEMPLATE_RATIO(Volume, Milliliters, Units::LiterPrefix<std::milli>::num, Units::LiterPrefix<std::milli>::den, mL);
+UNIT_TEMPLATE_RATIO(Volume, Microliters, Units::LiterPrefix<std::micro>::num, Units::LiterPrefix<std::micro>::den, uL);
+UNIT_TEMPLATE_RATIO(Volume, Nanoliters, Units::LiterPrefix<std::nano>::num, Units::LiterPrefix<std::nano>::den, nL);
+UNIT_TEMPLATE_RATIO(Volume, Picoliters, Units::LiterPrefix<std::pico>::num, Units::LiterPrefix<std::pico>::den, pL);
 
 #endif  // VOLUMETYPE_H_GUARD
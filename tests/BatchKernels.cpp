@@ -0,0 +1,221 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+// Every batch kernel documented as bit identical to Scalar is run on every
+// kernel the CPU supports and compared bit for bit, over unaligned spans
+// with ragged tails, in place and out of place. Kernels above
+// SupportedBatchKernel() are skipped and listed. Exits 1 on any mismatch.
+
+#include "UnitBatch.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace
+{
+   constexpr std::size_t COUNT = 1027;
+   constexpr Units::BatchKernel KERNELS[] = { Units::BatchKernel::SSE2, Units::BatchKernel::AVX2, Units::BatchKernel::AVX512 };
+
+   int failures = 0;
+
+   const char* Name(Units::BatchKernel kernel)
+   {
+      switch (kernel)
+      {
+      case Units::BatchKernel::SSE2:
+         return "SSE2";
+      case Units::BatchKernel::AVX2:
+         return "AVX2";
+      case Units::BatchKernel::AVX512:
+         return "AVX512";
+      default:
+         return "Scalar";
+      }
+   }
+
+   // Values across many magnitudes and both signs, with zeros, infinities
+   // and a NaN among them
+   template <class Value>
+   std::vector<Value> Values(std::size_t count, unsigned seed)
+   {
+      std::mt19937_64 random(seed);
+      std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+      std::uniform_int_distribution<int> exponent(-40, 40);
+      std::vector<Value> values(count);
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         values[i] = Value(std::ldexp(mantissa(random), exponent(random)));
+      }
+      values[3] = Value(0.0);
+      values[10] = -Value(0.0);
+      values[17] = std::numeric_limits<Value>::infinity();
+      values[24] = std::numeric_limits<Value>::quiet_NaN();
+      return values;
+   }
+
+   template <class Value>
+   void Expect(const std::vector<Value>& expected, const std::vector<Value>& actual, const char* test, Units::BatchKernel kernel)
+   {
+      for (std::size_t i = 0; i < expected.size(); ++i)
+      {
+         if (std::memcmp(&expected[i], &actual[i], sizeof(Value)) != 0)
+         {
+            std::printf("FAIL %s %s: index %zu is %.17g, Scalar gives %.17g\n", test, Name(kernel), i, double(actual[i]), double(expected[i]));
+            ++failures;
+            return;
+         }
+      }
+   }
+
+   // Starting one element in leaves the vectors unaligned with a ragged tail
+   template <class Value>
+   std::span<const Value> Unaligned(const std::vector<Value>& values)
+   {
+      return std::span<const Value>(values).subspan(1);
+   }
+   template <class Value>
+   std::span<Value> Unaligned(std::vector<Value>& values)
+   {
+      return std::span<Value>(values).subspan(1);
+   }
+
+   template <class Value>
+   void TestScaleOffset(Units::BatchKernel kernel, const char* test, Value factor, Value offset)
+   {
+      const std::vector<Value> input = Values<Value>(COUNT, 1);
+      std::vector<Value> expected(COUNT);
+      std::vector<Value> actual(COUNT);
+      Units::ScaleOffset(Unaligned(input), Unaligned(expected), factor, offset, Units::BatchKernel::Scalar);
+      Units::ScaleOffset(Unaligned(input), Unaligned(actual), factor, offset, kernel);
+      Expect(expected, actual, test, kernel);
+
+      std::vector<Value> inPlace = input;
+      Units::ScaleOffset(Unaligned(inPlace), Unaligned(inPlace), factor, offset, kernel);
+      inPlace[0] = expected[0];
+      Expect(expected, inPlace, test, kernel);
+   }
+
+   void TestVectorNorms(Units::BatchKernel kernel)
+   {
+      const std::vector<double> x = Values<double>(COUNT, 2);
+      const std::vector<double> y = Values<double>(COUNT, 3);
+      const std::vector<double> z = Values<double>(COUNT, 4);
+      std::vector<double> expected(COUNT);
+      std::vector<double> actual(COUNT);
+      Units::VectorNorms(Unaligned(x), Unaligned(y), Unaligned(z), Unaligned(expected), Units::BatchKernel::Scalar);
+      Units::VectorNorms(Unaligned(x), Unaligned(y), Unaligned(z), Unaligned(actual), kernel);
+      Expect(expected, actual, "VectorNorms", kernel);
+   }
+
+   void TestIntegrateMotion(Units::BatchKernel kernel, Units::Integrator integrator, const char* test)
+   {
+      const std::vector<double> positions = Values<double>(COUNT, 5);
+      const std::vector<double> velocities = Values<double>(COUNT, 6);
+      const std::vector<double> accelerations = Values<double>(COUNT, 7);
+      std::vector<double> previous = Values<double>(COUNT, 8);
+      // Entities without a Verlet step before
+      for (std::size_t i = 0; i < COUNT; i += 5)
+      {
+         previous[i] = std::numeric_limits<double>::quiet_NaN();
+      }
+
+      std::vector<double> expectedPositions = positions;
+      std::vector<double> expectedVelocities = velocities;
+      std::vector<double> expectedPrevious = previous;
+      std::vector<double> actualPositions = positions;
+      std::vector<double> actualVelocities = velocities;
+      std::vector<double> actualPrevious = previous;
+      // Two steps, the second Verlet step finishes the first
+      for (int step = 0; step < 2; ++step)
+      {
+         Units::IntegrateMotion(Unaligned(expectedPositions), Unaligned(expectedVelocities), Unaligned(accelerations), Unaligned(expectedPrevious),
+            1.0 / 60.0, integrator, Units::BatchKernel::Scalar);
+         Units::IntegrateMotion(Unaligned(actualPositions), Unaligned(actualVelocities), Unaligned(accelerations), Unaligned(actualPrevious),
+            1.0 / 60.0, integrator, kernel);
+      }
+      Expect(expectedPositions, actualPositions, test, kernel);
+      Expect(expectedVelocities, actualVelocities, test, kernel);
+      Expect(expectedPrevious, actualPrevious, test, kernel);
+   }
+
+   void TestFinishVerlet(Units::BatchKernel kernel)
+   {
+      const std::vector<double> accelerations = Values<double>(COUNT, 10);
+      std::vector<double> previous = Values<double>(COUNT, 11);
+      for (std::size_t i = 0; i < COUNT; i += 5)
+      {
+         previous[i] = std::numeric_limits<double>::quiet_NaN();
+      }
+      std::vector<double> expectedVelocities = Values<double>(COUNT, 12);
+      std::vector<double> expectedPrevious = previous;
+      std::vector<double> actualVelocities = expectedVelocities;
+      std::vector<double> actualPrevious = previous;
+      Units::FinishVerlet(Unaligned(expectedVelocities), Unaligned(accelerations), Unaligned(expectedPrevious), 1.0 / 60.0, Units::BatchKernel::Scalar);
+      Units::FinishVerlet(Unaligned(actualVelocities), Unaligned(accelerations), Unaligned(actualPrevious), 1.0 / 60.0, kernel);
+      Expect(expectedVelocities, actualVelocities, "FinishVerlet", kernel);
+      Expect(expectedPrevious, actualPrevious, "FinishVerlet", kernel);
+   }
+
+   void TestWrapDegrees(Units::BatchKernel kernel, Units::AngleWrap wrap, const char* test)
+   {
+      std::vector<double> degrees = Values<double>(COUNT, 9);
+      // Past 2^53 degrees, where the wrap leaves the vector pass
+      degrees[31] = 1e20;
+      degrees[32] = -3e17;
+      std::vector<double> expected(COUNT);
+      std::vector<double> actual(COUNT);
+      Units::WrapDegrees(Unaligned(degrees), Unaligned(expected), wrap, Units::BatchKernel::Scalar);
+      Units::WrapDegrees(Unaligned(degrees), Unaligned(actual), wrap, kernel);
+      Expect(expected, actual, test, kernel);
+
+      Units::WrapDegrees(Unaligned(degrees), Unaligned(degrees), wrap, kernel);
+      degrees[0] = expected[0];
+      Expect(expected, degrees, test, kernel);
+   }
+} //end anonymous namespace
+
+int main()
+{
+   const Units::BatchKernel supported = Units::SupportedBatchKernel();
+   for (Units::BatchKernel kernel : KERNELS)
+   {
+      if (kernel > supported)
+      {
+         std::printf("skipped %s, not supported by this CPU\n", Name(kernel));
+         continue;
+      }
+
+      TestScaleOffset<double>(kernel, "ScaleOffset double", 0.3048, 0.0);
+      TestScaleOffset<double>(kernel, "ScaleOffset double affine", 5.0 / 9.0, 255.37222222222223);
+      TestScaleOffset<float>(kernel, "ScaleOffset float", 0.3048f, 0.0f);
+      TestScaleOffset<float>(kernel, "ScaleOffset float affine", 5.0f / 9.0f, 255.37222f);
+      TestVectorNorms(kernel);
+      TestIntegrateMotion(kernel, Units::Integrator::Euler, "IntegrateMotion Euler");
+      TestIntegrateMotion(kernel, Units::Integrator::SemiImplicitEuler, "IntegrateMotion SemiImplicitEuler");
+      TestIntegrateMotion(kernel, Units::Integrator::Verlet, "IntegrateMotion Verlet");
+      TestFinishVerlet(kernel);
+      TestWrapDegrees(kernel, Units::AngleWrap::Positive, "WrapDegrees Positive");
+      TestWrapDegrees(kernel, Units::AngleWrap::Signed, "WrapDegrees Signed");
+      std::printf("checked %s\n", Name(kernel));
+   }
+
+   std::printf("%d failures\n", failures);
+   return (failures == 0) ? 0 : 1;
+}
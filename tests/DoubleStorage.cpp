@@ -0,0 +1,63 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+// Arrays, files and parsers read their elements as base unit doubles, so a
+// quantity holding FixedPoint or binary angle counts must not compile with
+// them. Built once per STORAGE_CASE: case 0 uses doubles and must compile,
+// every other case must fail.
+
+#include "BinaryAngle.h"
+#include "FixedPoint.h"
+#include "QuantityArray.h"
+#include "QuantityFile.h"
+#include "TimeType.h"
+#include "UnitParse.h"
+#include <cstdint>
+#include <ratio>
+#include <span>
+
+namespace
+{
+   using Nanoseconds = Units::RepresentedAs<Units::Time, Units::FixedPoint<std::int64_t, std::nano>>;
+} //end anonymous namespace
+
+int main()
+{
+#if STORAGE_CASE == 0
+   Units::QuantityArray<Units::Time> times(4);
+   Units::QuantityArray<Units::Angle> angles(4);
+   Units::QuantityArray<double> ratios(4);
+   Units::Time parsed;
+   return int(Units::Parse("1 s", parsed)) + int(times.Values().size() + angles.size() + ratios.size()) - 12;
+#elif STORAGE_CASE == 1
+   Units::QuantityArray<Nanoseconds> times(4);
+   return int(times.Values().size());
+#elif STORAGE_CASE == 2
+   Units::QuantityArray<Units::Bams64> angles(4);
+   return int(angles.Values().size());
+#elif STORAGE_CASE == 3
+   Nanoseconds times[4];
+   Units::QuantityFileWriter writer("times.uqty");
+   writer.Append(std::span<const Nanoseconds>(times));
+   return 0;
+#elif STORAGE_CASE == 4
+   Units::QuantityFileReader reader("angles.uqty");
+   return int(reader.View<Units::Bams64>(0, 0).size());
+#elif STORAGE_CASE == 5
+   Nanoseconds parsed;
+   return int(Units::Parse("1 s", parsed));
+#endif
+}
@@ -0,0 +1,51 @@
+#
+# Copyright 2022 Ben Saboff
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissionsand
+# limitations under the License.
+
+# Fails naming every unit declared with a UNIT_TEMPLATE macro in a *Type.h
+# header that is missing from Registry::RegisteredUnits in UnitRegistry.h
+#
+#    cmake -DUNITS_SOURCE_DIR=<source dir> -P tests/RegistryCoverage.cmake
+
+file(READ "${UNITS_SOURCE_DIR}/UnitRegistry.h" registry)
+string(REGEX MATCH "using RegisteredUnits = UnitList<[^>]*>" registered "${registry}")
+if(NOT registered)
+   message(FATAL_ERROR "RegisteredUnits not found in UnitRegistry.h")
+endif()
+string(REGEX MATCHALL "[A-Za-z_][A-Za-z0-9_]*" registered "${registered}")
+
+file(GLOB headers "${UNITS_SOURCE_DIR}/*Type.h")
+set(declared 0)
+set(missing "")
+foreach(header IN LISTS headers)
+   # A ; in a line splits it into several list items, only the first starts
+   # with the macro
+   file(STRINGS "${header}" lines REGEX "^UNIT_TEMPLATE[A-Z_]*\\(")
+   foreach(line IN LISTS lines)
+      if(line MATCHES "^UNIT_TEMPLATE[A-Z_]*\\([A-Za-z_]+, *([A-Za-z0-9_]+)")
+         math(EXPR declared "${declared} + 1")
+         list(FIND registered "${CMAKE_MATCH_1}" index)
+         if(index EQUAL -1)
+            get_filename_component(name "${header}" NAME)
+            list(APPEND missing "${CMAKE_MATCH_1} (${name})")
+         endif()
+      endif()
+   endforeach()
+endforeach()
+
+if(missing)
+   list(JOIN missing ", " missing)
+   message(FATAL_ERROR "Units missing from RegisteredUnits: ${missing}")
+endif()
+message(STATUS "All ${declared} units are registered")
@@ -0,0 +1,89 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+// Vector expressions assigned to an array they read, where the y and z
+// components read x and y of the same vector. Exits 1 on any mismatch.
+
+#include "LengthType.h"
+#include "Vec3.h"
+#include <cstddef>
+#include <cstdio>
+
+namespace
+{
+   constexpr std::size_t COUNT = 37;
+
+   int failures = 0;
+
+   // Sets every vector to (x, y, z)
+   void Fill(Units::Vec3Array<double>& vectors, double x, double y, double z)
+   {
+      for (std::size_t i = 0; i < vectors.size(); ++i)
+      {
+         vectors.Set(i, { x, y, z });
+      }
+   }
+
+   void Expect(const Units::Vec3Array<double>& vectors, double x, double y, double z, const char* test)
+   {
+      for (std::size_t i = 0; i < vectors.size(); ++i)
+      {
+         const Units::Vec3<double> vector = vectors[i];
+         if ((vector.x != x) || (vector.y != y) || (vector.z != z))
+         {
+            std::printf("FAIL %s: index %zu is (%g, %g, %g), expected (%g, %g, %g)\n", test, i, vector.x, vector.y, vector.z, x, y, z);
+            ++failures;
+            return;
+         }
+      }
+   }
+} //end anonymous namespace
+
+int main()
+{
+   Units::Vec3Array<double> c(COUNT);
+   Units::Vec3Array<double> d(COUNT);
+   Fill(d, 4.0, 5.0, 6.0);
+
+   Fill(c, 1.0, 2.0, 3.0);
+   c = Units::Cross(c, d);
+   Expect(c, -3.0, 6.0, -3.0, "c = Cross(c, d)");
+
+   Fill(c, 1.0, 2.0, 3.0);
+   c = Units::Cross(d, c);
+   Expect(c, 3.0, -6.0, 3.0, "c = Cross(d, c)");
+
+   Fill(c, 1.0, 2.0, 3.0);
+   c += Units::Cross(c, d);
+   Expect(c, -2.0, 8.0, 0.0, "c += Cross(c, d)");
+
+   Fill(c, 1.0, 2.0, 3.0);
+   c -= Units::Cross(c, d);
+   Expect(c, 4.0, -4.0, 6.0, "c -= Cross(c, d)");
+
+   // A different size evaluates into new arrays
+   Units::Vec3Array<double> e(COUNT + 3);
+   e = Units::Cross(c, d);
+   Expect(e, -54.0, 0.0, 36.0, "e = Cross(c, d), resized");
+   if (e.size() != COUNT)
+   {
+      std::printf("FAIL resized to %zu vectors, expected %zu\n", e.size(), COUNT);
+      ++failures;
+   }
+
+   std::printf("%d failures\n", failures);
+   return (failures == 0) ? 0 : 1;
+}
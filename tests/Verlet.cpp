@@ -0,0 +1,102 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+// Verlet steps of a KinematicState under constant acceleration, with every
+// value a short binary fraction so the analytic positions and velocities
+// are exact. After FinishVerlet the velocities must equal v0 + a t, and
+// stepping on must give the same bits as never finishing. Exits 1 on any
+// mismatch.
+
+#include "Kinematics.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+   constexpr std::size_t ENTITIES = 21;
+   constexpr int STEPS = 16;
+   constexpr double DT = 0.125;
+
+   int failures = 0;
+
+   double InitialPosition(std::size_t i) { return double(i) - 10.0; }
+   double InitialVelocity(std::size_t i) { return 0.5 * double(i % 7) - 1.5; }
+   double ConstantAcceleration(std::size_t i) { return 0.25 * double(i % 5) - 0.5; }
+
+   Units::KinematicState Start()
+   {
+      Units::KinematicState state(ENTITIES);
+      for (std::size_t i = 0; i < ENTITIES; ++i)
+      {
+         state.position.Set(i, { Units::Meters(InitialPosition(i)), Units::Meters(-InitialPosition(i)), Units::Meters(0.0) });
+         state.velocity.Set(i, { Units::MetersPerSecond(InitialVelocity(i)), Units::MetersPerSecond(0.0), Units::MetersPerSecond(-InitialVelocity(i)) });
+         state.acceleration.Set(i, { Units::MetersPerSecondSquared(ConstantAcceleration(i)), Units::MetersPerSecondSquared(-ConstantAcceleration(i)),
+            Units::MetersPerSecondSquared(1.0) });
+      }
+      return state;
+   }
+
+   void Steps(Units::KinematicState& state, int steps)
+   {
+      for (int step = 0; step < steps; ++step)
+      {
+         Units::Integrate(state, Units::Seconds(DT), Units::Integrator::Verlet);
+      }
+   }
+
+   void Expect(double actual, double expected, const char* what, std::size_t entity)
+   {
+      if (std::memcmp(&actual, &expected, sizeof(double)) != 0)
+      {
+         std::printf("FAIL %s of entity %zu is %.17g, expected %.17g\n", what, entity, actual, expected);
+         ++failures;
+      }
+   }
+} //end anonymous namespace
+
+int main()
+{
+   // Between steps the velocities are one step behind, FinishVerlet brings
+   // them up to the positions
+   Units::KinematicState finished = Start();
+   Steps(finished, STEPS);
+   Units::FinishVerlet(finished, Units::Seconds(DT));
+   const double t = STEPS * DT;
+   for (std::size_t i = 0; i < ENTITIES; ++i)
+   {
+      const double a = ConstantAcceleration(i);
+      const double v0 = InitialVelocity(i);
+      Expect(Units::Meters(finished.position.x[i]).value(), InitialPosition(i) + (v0 * t) + (0.5 * a * t * t), "position x", i);
+      Expect(Units::MetersPerSecond(finished.velocity.x[i]).value(), v0 + (a * t), "velocity x", i);
+      Expect(Units::MetersPerSecond(finished.velocity.y[i]).value(), 0.0 - (a * t), "velocity y", i);
+      Expect(Units::MetersPerSecond(finished.velocity.z[i]).value(), -v0 + t, "velocity z", i);
+   }
+
+   // Finishing does not change where the integration goes
+   Units::KinematicState unfinished = Start();
+   Steps(unfinished, 2 * STEPS);
+   Steps(finished, STEPS);
+   for (std::size_t i = 0; i < ENTITIES; ++i)
+   {
+      Expect(Units::Meters(finished.position.x[i]).value(), Units::Meters(unfinished.position.x[i]).value(), "continued position x", i);
+      Expect(Units::Meters(finished.position.y[i]).value(), Units::Meters(unfinished.position.y[i]).value(), "continued position y", i);
+      Expect(Units::MetersPerSecond(finished.velocity.z[i]).value(), Units::MetersPerSecond(unfinished.velocity.z[i]).value(), "continued velocity z", i);
+   }
+
+   std::printf("%d failures\n", failures);
+   return (failures == 0) ? 0 : 1;
+}
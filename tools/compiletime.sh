@@ -0,0 +1,155 @@
+#!/usr/bin/env bash
+#
+# Copyright 2022 Ben Saboff
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissionsand
+# limitations under the License.
+
+# compiletime.sh, build cost of the headers
+#
+#    CXX=g++ CXXFLAGS="-std=c++20 -O2" tools/compiletime.sh [--module | --initializers | --codegen]
+#
+# For every public header, a translation unit that only includes it is
+# parsed (-fsyntax-only, best of three) and compiled, and the parse time and
+# object size are printed, with the size of the static initializer sections
+# (.init_array / .ctors), which should be 0 for every header. Units.h is
+# then measured plain and with a precompiled header, and --module adds the
+# build time and object size of the Units module interface. Code importing
+# the module is not measured, GCC 12 crashes compiling it, and a parse only
+# pass does not read the module at all.
+#
+# --initializers only compiles each header's translation unit, plain and with
+# UNITS_HEADER_ONLY, and exits 1 naming every one with a static initializer.
+# The initializers test of the CMake build runs it.
+#
+# --codegen compiles the README's (NewPosition - oldPosition) / FrameTime on
+# Length and Time and the same expression on doubles, prints both bodies and
+# exits 1 unless the instructions are the same. The frame_rate_codegen test
+# runs it.
+
+set -euo pipefail
+
+ROOT="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+CXX="${CXX:-g++}"
+CXXFLAGS="${CXXFLAGS:--std=c++20 -O2}"
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+# Best of three wall times of a command, in milliseconds
+best_ms()
+{
+   local best=""
+   for _ in 1 2 3; do
+      local start end
+      start=$(date +%s%N)
+      "$@" > /dev/null
+      end=$(date +%s%N)
+      local ms=$(( (end - start) / 1000000 ))
+      if [[ -z "$best" || $ms -lt $best ]]; then best=$ms; fi
+   done
+   echo "$best"
+}
+
+object_bytes()
+{
+   size "$1" | awk 'NR == 2 { print $1 + $2 + $3 }'
+}
+
+initializer_bytes()
+{
+   size -A "$1" | awk '$1 ~ /^\.(init_array|ctors)/ { total += $2 } END { print total + 0 }'
+}
+
+# name, source file, extra flags
+measure()
+{
+   local name="$1" source="$2"
+   shift 2
+   local parse
+   parse=$(best_ms $CXX $CXXFLAGS "$@" -I"$ROOT" -fsyntax-only "$source")
+   $CXX $CXXFLAGS "$@" -I"$ROOT" -c "$source" -o "$WORK/measure.o"
+   printf "%-28s %8s ms %10s bytes %6s bytes\n" "$name" "$parse" "$(object_bytes "$WORK/measure.o")" "$(initializer_bytes "$WORK/measure.o")"
+}
+
+# Instructions of the one function in an assembly listing, without labels
+# and directives
+instructions()
+{
+   grep -v -E '^[[:space:]]*(\.|#|$)|^[^[:space:]].*:' "$1" | sed -E 's/^[[:space:]]+//; s/[[:space:]]+/ /g'
+}
+
+if [[ "${1:-}" == "--codegen" ]]; then
+   cat > "$WORK/typed.cpp" << 'EOF'
+#include "LengthType.h"
+#include "SpeedType.h"
+#include "TimeType.h"
+Units::Speed FrameRate(Units::Length NewPosition, Units::Length oldPosition, Units::Time FrameTime)
+{
+   return (NewPosition - oldPosition) / FrameTime;
+}
+EOF
+   cat > "$WORK/double.cpp" << 'EOF'
+double FrameRate(double NewPosition, double oldPosition, double FrameTime)
+{
+   return (NewPosition - oldPosition) / FrameTime;
+}
+EOF
+   for source in typed double; do
+      $CXX $CXXFLAGS -I"$ROOT" -fno-asynchronous-unwind-tables -S "$WORK/$source.cpp" -o "$WORK/$source.s"
+      instructions "$WORK/$source.s" > "$WORK/$source.txt"
+      echo "$source:"
+      sed 's/^/   /' "$WORK/$source.txt"
+   done
+   if ! cmp -s "$WORK/typed.txt" "$WORK/double.txt"; then
+      echo "the quantity version compiles to other instructions than the double version"
+      exit 1
+   fi
+   exit 0
+fi
+
+if [[ "${1:-}" == "--initializers" ]]; then
+   failed=0
+   for header in "$ROOT"/*.h; do
+      name="$(basename "$header")"
+      echo "#include \"$name\"" > "$WORK/include.cpp"
+      for mode in "" "-DUNITS_HEADER_ONLY"; do
+         $CXX $CXXFLAGS $mode -I"$ROOT" -c "$WORK/include.cpp" -o "$WORK/include.o"
+         bytes=$(initializer_bytes "$WORK/include.o")
+         if [[ "$bytes" != 0 ]]; then
+            echo "$name ${mode:-plain}: $bytes bytes of static initializers"
+            failed=1
+         fi
+      done
+   done
+   exit $failed
+fi
+
+printf "%-28s %11s %16s %12s\n" "translation unit" "parse" "object" "initializers"
+for header in "$ROOT"/*.h; do
+   name="$(basename "$header")"
+   echo "#include \"$name\"" > "$WORK/include.cpp"
+   measure "$name" "$WORK/include.cpp"
+done
+
+# Units.h through a precompiled header, the .gch sits beside a copy of the
+# header so the include finds it first
+echo '#include "Units.h"' > "$WORK/pch.cpp"
+cp "$ROOT/Units.h" "$WORK/Units.h"
+build=$(best_ms $CXX $CXXFLAGS -I"$ROOT" -x c++-header "$WORK/Units.h" -o "$WORK/Units.h.gch")
+printf "%-28s %8s ms\n" "Units.h.gch (build)" "$build"
+( cd "$WORK" && measure "Units.h (precompiled)" "$WORK/pch.cpp" -I"$WORK" )
+
+if [[ "${1:-}" == "--module" ]]; then
+   ( cd "$WORK"
+     build=$(best_ms $CXX $CXXFLAGS -fmodules-ts -I"$ROOT" -c -x c++ "$ROOT/Units.cppm" -o "$WORK/Units.o")
+     printf "%-28s %8s ms %10s bytes\n" "Units.cppm (build)" "$build" "$(object_bytes "$WORK/Units.o")" )
+fi
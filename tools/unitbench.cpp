@@ -0,0 +1,716 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+// unitbench, micro benchmarks of every registered unit and the cross
+// dimension operators, written as JSON
+//
+//    unitbench [--filter TEXT] [--min-time MS] [-o FILE] [--baseline FILE [--threshold PERCENT]]
+//
+//    --filter TEXT      only cases whose name contains TEXT
+//    --min-time MS      shortest timed sample, 2 ms by default
+//    -o FILE            write the JSON results to FILE instead of standard output
+//    --baseline FILE    compare against an earlier JSON result, every case
+//                       slower by more than the threshold (10% by default) is
+//                       listed on standard error and the exit code is 1
+//
+// Every unit is timed for construction from a double, value(), comparison
+// against a double and operator<<. User literals call the same constructor
+// and are covered by construction. Vectors are timed as separate scalar
+// triplets, as Vec3 and as Vec3Array for a position step and a norm. Each
+// case runs over ELEMENTS values and reports the best of SAMPLES samples.
+// The kinematics cases step a whole frame of KINEMATIC_ENTITIES entities,
+// ns_per_op is per entity and elements_per_s is entities per second. The
+// parse cases count bytes of text, elements_per_s is bytes per second. The
+// parallel cases run one operation over PARALLEL_ELEMENTS values on pools of
+// 1, 2, 4, ... threads up to every hardware thread.
+//
+// Built by the unitbench CMake target, or header only from this directory:
+//    g++ -std=c++20 -O2 -DUNITS_HEADER_ONLY -I.. unitbench.cpp -o unitbench
+
+#include "Kinematics.h"
+#include "UnitBatch.h"
+#include "UnitParallel.h"
+#include "UnitParse.h"
+#include "UnitRegistry.h"
+#include "Vec3.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+   constexpr std::size_t ELEMENTS = 4096;
+   constexpr std::size_t STREAM_ELEMENTS = 256;
+   constexpr std::size_t KINEMATIC_ENTITIES = 5000000;
+   constexpr std::size_t PARALLEL_ELEMENTS = 4000000;
+   constexpr int SAMPLES = 5;
+
+   struct Options
+   {
+      std::string filter;
+      double minimumSeconds = 0.002;
+      std::string output;
+      std::string baseline;
+      double threshold = 10.0;
+   };
+
+   struct Result
+   {
+      std::string name;
+      double nanosecondsPerOperation;
+      double elementsPerSecond;
+   };
+
+   // Keeps the optimizer from dropping a result it cannot see used
+   template <class Value>
+   inline void KeepAlive(const Value& value)
+   {
+      __asm__ __volatile__("" : : "r,m"(value) : "memory");
+   }
+
+   class Bench
+   {
+   public:
+      explicit Bench(const Options& options) : m_options(options) {}
+
+      // Times body(), which handles elements values, in doubling batches
+      // until one batch takes the minimum time, best of SAMPLES batches
+      template <class Body>
+      void Run(const std::string& name, std::size_t elements, Body&& body)
+      {
+         if (!m_options.filter.empty() && (name.find(m_options.filter) == std::string::npos))
+         {
+            return;
+         }
+
+         std::size_t iterations = 1;
+         double best = 0.0;
+         while (true)
+         {
+            const double seconds = Time(iterations, body);
+            if (seconds >= m_options.minimumSeconds)
+            {
+               best = seconds;
+               break;
+            }
+            iterations *= 2;
+         }
+         for (int sample = 1; sample < SAMPLES; ++sample)
+         {
+            best = std::min(best, Time(iterations, body));
+         }
+
+         const double operations = double(iterations) * double(elements);
+         m_results.push_back({ name, (best * 1.0e9) / operations, operations / best });
+      }
+
+      const std::vector<Result>& Results() const { return m_results; }
+
+   private:
+      template <class Body>
+      static double Time(std::size_t iterations, Body& body)
+      {
+         const auto start = std::chrono::steady_clock::now();
+         for (std::size_t i = 0; i < iterations; ++i)
+         {
+            body();
+         }
+         return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      }
+
+      const Options& m_options;
+      std::vector<Result> m_results;
+   };
+
+   // Inputs spread over three decades so no case runs on special values
+   std::vector<double> Inputs(std::size_t count)
+   {
+      std::vector<double> values(count);
+      for (std::size_t i = 0; i < count; ++i)
+      {
+         values[i] = 1.0 + double((i * 7919) % 1000);
+      }
+      return values;
+   }
+
+   template <class Unit>
+   void BenchUnit(Bench& bench)
+   {
+      using Base = Units::Quantity<typename Unit::dimension>;
+      const std::string name(Unit::suffix);
+      const std::vector<double> inputs = Inputs(ELEMENTS);
+      std::vector<Base> bases(ELEMENTS);
+      std::vector<Unit> units(ELEMENTS);
+      std::vector<double> values(ELEMENTS);
+      for (std::size_t i = 0; i < ELEMENTS; ++i)
+      {
+         units[i] = Unit(inputs[i]);
+      }
+
+      bench.Run(name + "/construct", ELEMENTS, [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            bases[i] = Unit(inputs[i]);
+         }
+         KeepAlive(bases.data());
+      });
+      bench.Run(name + "/value", ELEMENTS, [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            values[i] = units[i].value();
+         }
+         KeepAlive(values.data());
+      });
+      bench.Run(name + "/compare_double", ELEMENTS, [&]
+      {
+         std::size_t below = 0;
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            below += std::size_t(units[i] < 500.0);
+         }
+         KeepAlive(below);
+      });
+
+      std::ostringstream stream;
+      bench.Run(name + "/ostream", STREAM_ELEMENTS, [&]
+      {
+         stream.str(std::string());
+         for (std::size_t i = 0; i < STREAM_ELEMENTS; ++i)
+         {
+            stream << units[i];
+         }
+         KeepAlive(stream.tellp());
+      });
+   }
+
+   template <class... Registered>
+   void BenchUnits(Bench& bench, Units::Registry::UnitList<Registered...>)
+   {
+      (BenchUnit<Registered>(bench), ...);
+   }
+
+   // lhs * rhs and lhs / rhs over arrays of two base quantities
+   template <class Lhs, class Rhs>
+   void BenchOperators(Bench& bench, const std::string& lhsName, const std::string& rhsName)
+   {
+      const std::vector<double> inputs = Inputs(ELEMENTS);
+      std::vector<Lhs> lhs(ELEMENTS);
+      std::vector<Rhs> rhs(ELEMENTS);
+      for (std::size_t i = 0; i < ELEMENTS; ++i)
+      {
+         lhs[i] = std::bit_cast<Lhs>(inputs[i]);
+         rhs[i] = std::bit_cast<Rhs>(inputs[ELEMENTS - 1 - i]);
+      }
+
+      std::vector<decltype(Lhs() * Rhs())> products(ELEMENTS);
+      bench.Run(lhsName + "*" + rhsName, ELEMENTS, [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            products[i] = lhs[i] * rhs[i];
+         }
+         KeepAlive(products.data());
+      });
+
+      std::vector<decltype(Lhs() / Rhs())> quotients(ELEMENTS);
+      bench.Run(lhsName + "/" + rhsName, ELEMENTS, [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            quotients[i] = lhs[i] / rhs[i];
+         }
+         KeepAlive(quotients.data());
+      });
+   }
+
+   void BenchOperators(Bench& bench)
+   {
+      using namespace Units;
+      BenchOperators<Length, Time>(bench, "Length", "Time");
+      BenchOperators<Speed, Time>(bench, "Speed", "Time");
+      BenchOperators<Length, Length>(bench, "Length", "Length");
+      BenchOperators<Area, Length>(bench, "Area", "Length");
+      BenchOperators<Volume, Area>(bench, "Volume", "Area");
+      BenchOperators<Mass, Volume>(bench, "Mass", "Volume");
+      BenchOperators<Mass, Acceleration>(bench, "Mass", "Acceleration");
+      BenchOperators<Force, Length>(bench, "Force", "Length");
+      BenchOperators<Force, Area>(bench, "Force", "Area");
+      BenchOperators<Energy, Time>(bench, "Energy", "Time");
+      BenchOperators<Power, Time>(bench, "Power", "Time");
+      BenchOperators<Angle, Time>(bench, "Angle", "Time");
+      BenchOperators<AngularSpeed, Time>(bench, "AngularSpeed", "Time");
+      BenchOperators<Density, Volume>(bench, "Density", "Volume");
+      BenchOperators<Temperature, Time>(bench, "Temperature", "Time");
+   }
+
+   // position += velocity * frameTime and |position| as three separate
+   // scalars, packed Vec3 and the structure of arrays Vec3Array
+   void BenchVectors(Bench& bench)
+   {
+      using namespace Units;
+      const std::vector<double> inputs = Inputs(ELEMENTS);
+      const Time frameTime = Seconds(0.01);
+
+      std::vector<Length> px(ELEMENTS);
+      std::vector<Length> py(ELEMENTS);
+      std::vector<Length> pz(ELEMENTS);
+      std::vector<Speed> vx(ELEMENTS);
+      std::vector<Speed> vy(ELEMENTS);
+      std::vector<Speed> vz(ELEMENTS);
+      std::vector<Vec3<Length>> positions(ELEMENTS);
+      std::vector<Vec3<Speed>> velocities(ELEMENTS);
+      Vec3Array<Length> positionArray(ELEMENTS);
+      Vec3Array<Speed> velocityArray(ELEMENTS);
+      for (std::size_t i = 0; i < ELEMENTS; ++i)
+      {
+         const Vec3<Length> position{ Meters(inputs[i]), Meters(inputs[ELEMENTS - 1 - i]), Meters(inputs[(i * 3) % ELEMENTS]) };
+         const Vec3<Speed> velocity{ MetersPerSecond(inputs[(i * 5) % ELEMENTS]), MetersPerSecond(inputs[(i * 7) % ELEMENTS]), MetersPerSecond(1.0) };
+         px[i] = position.x;
+         py[i] = position.y;
+         pz[i] = position.z;
+         vx[i] = velocity.x;
+         vy[i] = velocity.y;
+         vz[i] = velocity.z;
+         positions[i] = position;
+         velocities[i] = velocity;
+         positionArray.Set(i, position);
+         velocityArray.Set(i, velocity);
+      }
+
+      bench.Run("vec3/step/triplets", ELEMENTS, [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            px[i] += vx[i] * frameTime;
+            py[i] += vy[i] * frameTime;
+            pz[i] += vz[i] * frameTime;
+         }
+         KeepAlive(px.data());
+      });
+      bench.Run("vec3/step/Vec3", ELEMENTS, [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            positions[i] += velocities[i] * frameTime;
+         }
+         KeepAlive(positions.data());
+      });
+      bench.Run("vec3/step/Vec3Array", ELEMENTS, [&]
+      {
+         positionArray += velocityArray * frameTime;
+         KeepAlive(positionArray.x.begin());
+      });
+
+      std::vector<Length> norms(ELEMENTS);
+      bench.Run("vec3/norm/triplets", ELEMENTS, [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            norms[i] = Meters(std::sqrt((Meters(px[i]).value() * Meters(px[i]).value()) + (Meters(py[i]).value() * Meters(py[i]).value()) +
+               (Meters(pz[i]).value() * Meters(pz[i]).value())));
+         }
+         KeepAlive(norms.data());
+      });
+      bench.Run("vec3/norm/Vec3", ELEMENTS, [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            norms[i] = Norm(positions[i]);
+         }
+         KeepAlive(norms.data());
+      });
+      QuantityArray<Length> normArray(ELEMENTS);
+      bench.Run("vec3/norm/Vec3Array", ELEMENTS, [&]
+      {
+         normArray = Norm(positionArray);
+         KeepAlive(normArray.begin());
+      });
+   }
+
+   void BenchKinematics(Bench& bench)
+   {
+      using namespace Units;
+      const std::vector<double> inputs = Inputs(ELEMENTS);
+      const Time frameTime = Seconds(1.0 / 60.0);
+
+      // The per entity loop the state replaces, Vec3 members one entity at a time
+      struct Entity
+      {
+         Vec3<Length> position;
+         Vec3<Speed> velocity;
+         Vec3<Acceleration> acceleration;
+      };
+      std::vector<Entity> entities(KINEMATIC_ENTITIES);
+      KinematicState state(KINEMATIC_ENTITIES);
+      for (std::size_t i = 0; i < KINEMATIC_ENTITIES; ++i)
+      {
+         const Entity entity{ { Meters(inputs[i % ELEMENTS]), Meters(inputs[(i * 3) % ELEMENTS]), Meters(0.0) },
+            { MetersPerSecond(inputs[(i * 5) % ELEMENTS]), MetersPerSecond(inputs[(i * 7) % ELEMENTS]), MetersPerSecond(1.0) },
+            { MetersPerSecondSquared(0.0), MetersPerSecondSquared(0.0), -StandardGravity(1.0) } };
+         entities[i] = entity;
+         state.position.Set(i, entity.position);
+         state.velocity.Set(i, entity.velocity);
+         state.acceleration.Set(i, entity.acceleration);
+      }
+
+      bench.Run("kinematics/frame/Vec3", KINEMATIC_ENTITIES, [&]
+      {
+         for (Entity& entity : entities)
+         {
+            entity.velocity += entity.acceleration * frameTime;
+            entity.position += entity.velocity * frameTime;
+         }
+         KeepAlive(entities.data());
+      });
+
+      const std::pair<const char*, Integrator> integrators[] = {
+         { "Euler", Integrator::Euler }, { "SemiImplicitEuler", Integrator::SemiImplicitEuler }, { "Verlet", Integrator::Verlet } };
+      for (const auto& [name, integrator] : integrators)
+      {
+         bench.Run(std::string("kinematics/frame/") + name, KINEMATIC_ENTITIES, [&]
+         {
+            Integrate(state, frameTime, integrator);
+            KeepAlive(state.position.x.begin());
+         });
+      }
+
+      ThreadPool& pool = ThreadPool::Default();
+      bench.Run("kinematics/frame/SemiImplicitEuler/pool", KINEMATIC_ENTITIES, [&]
+      {
+         Integrate(pool, state, frameTime, Integrator::SemiImplicitEuler);
+         KeepAlive(state.position.x.begin());
+      });
+   }
+
+   // The frame rate of the README, (NewPosition - oldPosition) / FrameTime,
+   // against the same divide on plain doubles
+   void BenchFrameRate(Bench& bench)
+   {
+      using namespace Units;
+      const std::vector<double> inputs = Inputs(ELEMENTS);
+      const Time frameTime = Seconds(1.0 / 60.0);
+      const double frameSeconds = 1.0 / 60.0;
+      std::vector<Length> newPositions(ELEMENTS);
+      std::vector<Length> oldPositions(ELEMENTS);
+      std::vector<Speed> rates(ELEMENTS);
+      std::vector<double> newValues(ELEMENTS);
+      std::vector<double> oldValues(ELEMENTS);
+      std::vector<double> rateValues(ELEMENTS);
+      for (std::size_t i = 0; i < ELEMENTS; ++i)
+      {
+         newValues[i] = inputs[i];
+         oldValues[i] = inputs[ELEMENTS - 1 - i];
+         newPositions[i] = Meters(newValues[i]);
+         oldPositions[i] = Meters(oldValues[i]);
+      }
+
+      bench.Run("rate/(NewPosition-oldPosition)/FrameTime", ELEMENTS, [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            rates[i] = (newPositions[i] - oldPositions[i]) / frameTime;
+         }
+         KeepAlive(rates.data());
+      });
+      bench.Run("rate/double", ELEMENTS, [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            rateValues[i] = (newValues[i] - oldValues[i]) / frameSeconds;
+         }
+         KeepAlive(rateValues.data());
+      });
+   }
+
+   // The decibel kernels at both precisions against std::pow and std::log10
+   void BenchDecibels(Bench& bench)
+   {
+      using namespace Units;
+      const std::vector<double> inputs = Inputs(ELEMENTS);
+      std::vector<double> decibels(ELEMENTS);
+      std::vector<double> ratios(ELEMENTS);
+      std::vector<double> output(ELEMENTS);
+      for (std::size_t i = 0; i < ELEMENTS; ++i)
+      {
+         decibels[i] = (inputs[i] - 500.0) / 5.0;
+         ratios[i] = inputs[i] / 1000.0;
+      }
+
+      const std::pair<const char*, BatchPrecision> precisions[] = { { "Strict", BatchPrecision::Strict }, { "Fast", BatchPrecision::Fast } };
+      for (const auto& [name, precision] : precisions)
+      {
+         bench.Run(std::string("decibel/DecibelsToRatio/") + name, ELEMENTS, [&]
+         {
+            DecibelsToRatio(decibels, output, 1.0, precision);
+            KeepAlive(output.data());
+         });
+         bench.Run(std::string("decibel/RatioToDecibels/") + name, ELEMENTS, [&]
+         {
+            RatioToDecibels(ratios, output, 1.0, precision);
+            KeepAlive(output.data());
+         });
+      }
+      bench.Run("decibel/std::pow", ELEMENTS, [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            output[i] = std::pow(10.0, decibels[i] / 10.0);
+         }
+         KeepAlive(output.data());
+      });
+      bench.Run("decibel/std::log10", ELEMENTS, [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            output[i] = 10.0 * std::log10(ratios[i]);
+         }
+         KeepAlive(output.data());
+      });
+   }
+
+   // Parser throughput in bytes of text, one field at a time and a column
+   void BenchParse(Bench& bench)
+   {
+      using namespace Units;
+      const std::vector<double> inputs = Inputs(ELEMENTS);
+      const char* const suffixes[] = { "ft", "m", "nmi", "km" };
+      std::vector<std::string> fields(ELEMENTS);
+      std::string column;
+      for (std::size_t i = 0; i < ELEMENTS; ++i)
+      {
+         fields[i] = std::to_string(inputs[i] / 8.0) + suffixes[i % std::size(suffixes)];
+         column += fields[i] + '\n';
+      }
+
+      std::vector<Length> lengths(ELEMENTS);
+      bench.Run("parse/Parse", column.size(), [&]
+      {
+         for (std::size_t i = 0; i < ELEMENTS; ++i)
+         {
+            Parse(fields[i], lengths[i]);
+         }
+         KeepAlive(lengths.data());
+      });
+      bench.Run("parse/ParseColumn", column.size(), [&]
+      {
+         KeepAlive(ParseColumn(column, std::span<Length>(lengths)).count);
+      });
+   }
+
+   // One conversion and one sum over the same values on growing pools
+   void BenchThreads(Bench& bench)
+   {
+      using namespace Units;
+      const std::vector<double> inputs = Inputs(PARALLEL_ELEMENTS);
+      std::vector<double> output(PARALLEL_ELEMENTS);
+      std::vector<Length> lengths(PARALLEL_ELEMENTS);
+      for (std::size_t i = 0; i < PARALLEL_ELEMENTS; ++i)
+      {
+         lengths[i] = Meters(inputs[i]);
+      }
+      const UnitId feet = FindUnit("ft");
+      const UnitId meters = FindUnit("m");
+
+      const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+      for (unsigned threads = 1; ; threads *= 2)
+      {
+         threads = std::min(threads, hardware);
+         ThreadPool pool(threads);
+         const std::string suffix = "/threads=" + std::to_string(threads);
+         bench.Run("parallel/convert" + suffix, PARALLEL_ELEMENTS, [&]
+         {
+            convert(pool, inputs, output, feet, meters);
+            KeepAlive(output.data());
+         });
+         bench.Run("parallel/Sum" + suffix, PARALLEL_ELEMENTS, [&]
+         {
+            KeepAlive(Sum(pool, std::span<const Length>(lengths)));
+         });
+         if (threads == hardware)
+         {
+            break;
+         }
+      }
+   }
+
+   std::string ToJson(const std::vector<Result>& results)
+   {
+      std::string json = "{\n  \"compiler\": \"" __VERSION__ "\",\n  \"batch_kernel\": " +
+         std::to_string(int(Units::SupportedBatchKernel())) + ",\n  \"results\": [\n";
+      char number[64];
+      for (std::size_t i = 0; i < results.size(); ++i)
+      {
+         json += "    {\"name\": \"" + results[i].name + "\", \"ns_per_op\": ";
+         json.append(number, std::to_chars(number, number + sizeof(number), results[i].nanosecondsPerOperation).ptr);
+         json += ", \"elements_per_s\": ";
+         json.append(number, std::to_chars(number, number + sizeof(number), results[i].elementsPerSecond).ptr);
+         json += (i + 1 < results.size()) ? "},\n" : "}\n";
+      }
+      json += "  ]\n}\n";
+      return json;
+   }
+
+   // Reads the name and ns_per_op of every result written by ToJson
+   std::map<std::string, double> ReadBaseline(const std::string& path)
+   {
+      std::ifstream file(path);
+      if (!file)
+      {
+         throw std::runtime_error("unitbench: cannot open baseline " + path);
+      }
+      const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+      std::map<std::string, double> baseline;
+      constexpr std::string_view NAME = "\"name\": \"";
+      constexpr std::string_view TIME = "\"ns_per_op\": ";
+      std::size_t position = 0;
+      while ((position = text.find(NAME, position)) != std::string::npos)
+      {
+         const std::size_t nameBegin = position + NAME.size();
+         const std::size_t nameEnd = text.find('"', nameBegin);
+         const std::size_t time = text.find(TIME, nameEnd);
+         if ((nameEnd == std::string::npos) || (time == std::string::npos))
+         {
+            break;
+         }
+         double value = 0.0;
+         const char* const first = text.data() + time + TIME.size();
+         if (std::from_chars(first, text.data() + text.size(), value).ec == std::errc())
+         {
+            baseline[text.substr(nameBegin, nameEnd - nameBegin)] = value;
+         }
+         position = time;
+      }
+      return baseline;
+   }
+
+   // Lists every case slower than the baseline by more than the threshold
+   bool Compare(const std::vector<Result>& results, const Options& options)
+   {
+      const std::map<std::string, double> baseline = ReadBaseline(options.baseline);
+      std::size_t compared = 0;
+      std::size_t regressions = 0;
+      for (const Result& result : results)
+      {
+         const auto found = baseline.find(result.name);
+         if (found == baseline.end())
+         {
+            continue;
+         }
+         ++compared;
+         const double change = ((result.nanosecondsPerOperation / found->second) - 1.0) * 100.0;
+         if (change > options.threshold)
+         {
+            ++regressions;
+            std::fprintf(stderr, "regression %-40s %10.3f ns -> %10.3f ns  (+%.1f%%)\n", result.name.c_str(), found->second,
+               result.nanosecondsPerOperation, change);
+         }
+      }
+      std::fprintf(stderr, "unitbench: %zu of %zu cases compared slower than the baseline by more than %.1f%%\n", regressions, compared, options.threshold);
+      return regressions == 0;
+   }
+
+   Options ParseArguments(int argc, char** argv)
+   {
+      Options options;
+      for (int i = 1; i < argc; ++i)
+      {
+         const std::string_view argument = argv[i];
+         const bool hasValue = (i + 1) < argc;
+         if ((argument == "--filter") && hasValue)
+         {
+            options.filter = argv[++i];
+         }
+         else if ((argument == "--min-time") && hasValue)
+         {
+            options.minimumSeconds = std::stod(argv[++i]) / 1000.0;
+         }
+         else if ((argument == "-o") && hasValue)
+         {
+            options.output = argv[++i];
+         }
+         else if ((argument == "--baseline") && hasValue)
+         {
+            options.baseline = argv[++i];
+         }
+         else if ((argument == "--threshold") && hasValue)
+         {
+            options.threshold = std::stod(argv[++i]);
+         }
+         else
+         {
+            throw std::invalid_argument("unitbench: unexpected argument " + std::string(argument));
+         }
+      }
+      return options;
+   }
+} //end anonymous namespace
+
+int main(int argc, char** argv)
+{
+   try
+   {
+      const Options options = ParseArguments(argc, argv);
+
+      Bench bench(options);
+      BenchUnits(bench, Units::Registry::RegisteredUnits{});
+      BenchOperators(bench);
+      BenchVectors(bench);
+      BenchKinematics(bench);
+      BenchFrameRate(bench);
+      BenchDecibels(bench);
+      BenchParse(bench);
+      BenchThreads(bench);
+
+      const std::string json = ToJson(bench.Results());
+      if (options.output.empty())
+      {
+         std::fwrite(json.data(), 1, json.size(), stdout);
+      }
+      else
+      {
+         std::ofstream file(options.output);
+         file << json;
+         if (!file)
+         {
+            throw std::runtime_error("unitbench: cannot write " + options.output);
+         }
+      }
+
+      return (options.baseline.empty() || Compare(bench.Results(), options)) ? 0 : 1;
+   }
+   catch (const std::exception& error)
+   {
+      std::fprintf(stderr, "%s\n", error.what());
+      std::fputs("usage: unitbench [--filter TEXT] [--min-time MS] [-o FILE] [--baseline FILE [--threshold PERCENT]]\n", stderr);
+      return 2;
+   }
+}
@@ -0,0 +1,656 @@
+/*
+Copyright 2022 Ben Saboff
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissionsand
+limitations under the License.
+*/
+
+// unitconv, converts columns of a CSV or TSV file from one unit to another
+//
+//    unitconv [options] --col NAME:FROM->TO [--col ...] input.csv
+//
+//    --col NAME:FROM->TO   convert column NAME (header name, or 0 based index)
+//                          from unit FROM to unit TO, units are the user
+//                          literal suffixes, e.g. --col 'alt:ft->m' --col 'spd:kt->mps'
+//                          (quoted so the shell does not see the >)
+//    --tsv                 tab separated input
+//    --delimiter C         field separator, comma by default
+//    --no-header           the first line is data, columns are given by index
+//    --precision N         fixed notation with N decimals instead of the
+//                          shortest round trip number
+//    --threads N           worker threads, all hardware threads by default
+//    -o FILE               output file, standard output by default
+//
+// The input is memory mapped and cut into chunks on line boundaries that a
+// pool of threads converts, the chunks are written back in input order.
+// Fields that are not plain numbers are copied unchanged and counted. Quoted
+// fields are never converted and may not contain line breaks.
+//
+// Built by the unitconv CMake target, or header only from this directory:
+//    g++ -std=c++20 -O2 -DUNITS_HEADER_ONLY -I.. -pthread unitconv.cpp -o unitconv
+
+#include "UnitFormat.h"
+#include "UnitRegistry.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+   // Input bytes per chunk handed to a worker
+   constexpr std::size_t CHUNK_SIZE = std::size_t(8) << 20;
+   // Chunks converted ahead of the writer per worker, bounds the memory held
+   constexpr std::size_t CHUNKS_IN_FLIGHT = 4;
+
+   struct ColumnConversion
+   {
+      std::string name;
+      std::size_t column;
+      Units::UnitId from;
+      Units::UnitId to;
+   };
+
+   struct Options
+   {
+      std::vector<ColumnConversion> columns;
+      char delimiter = ',';
+      bool header = true;
+      int precision = Units::SHORTEST_ROUND_TRIP;
+      unsigned threads = 0;
+      std::string input;
+      std::string output;
+   };
+
+   // Totals reported at the end
+   struct Statistics
+   {
+      std::atomic<std::size_t> rows{ 0 };
+      std::atomic<std::size_t> unconverted{ 0 };
+   };
+
+   void PrintUsage()
+   {
+      std::fputs("usage: unitconv [--tsv | --delimiter C] [--no-header] [--precision N] [--threads N] [-o FILE]\n"
+         "                --col NAME:FROM->TO [--col ...] input\n", stderr);
+   }
+
+   bool IsBlank(char c)
+   {
+      return (c == ' ') || (c == '\t') || (c == '\r');
+   }
+
+   std::string_view Trim(std::string_view text)
+   {
+      while (!text.empty() && IsBlank(text.front()))
+      {
+         text.remove_prefix(1);
+      }
+      while (!text.empty() && IsBlank(text.back()))
+      {
+         text.remove_suffix(1);
+      }
+      return text;
+   }
+
+   unsigned ParseCount(std::string_view text, const char* option)
+   {
+      unsigned value = 0;
+      const std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+      if ((result.ec != std::errc()) || (result.ptr != (text.data() + text.size())))
+      {
+         throw std::invalid_argument(std::string("unitconv: ") + option + " needs a number");
+      }
+      return value;
+   }
+
+   // "alt:ft->m"
+   ColumnConversion ParseColumnSpec(std::string_view spec)
+   {
+      const std::size_t arrow = spec.rfind("->");
+      const std::size_t colon = (arrow == std::string_view::npos) ? std::string_view::npos : spec.rfind(':', arrow);
+      if ((colon == std::string_view::npos) || (colon == 0))
+      {
+         throw std::invalid_argument("unitconv: --col expects NAME:FROM->TO, got " + std::string(spec));
+      }
+
+      const std::string_view from = spec.substr(colon + 1, arrow - colon - 1);
+      const std::string_view to = spec.substr(arrow + 2);
+      ColumnConversion conversion{ std::string(spec.substr(0, colon)), 0, Units::FindUnit(from), Units::FindUnit(to) };
+      if (conversion.from == Units::UnitId::Invalid)
+      {
+         throw std::invalid_argument("unitconv: unknown unit " + std::string(from));
+      }
+      if (conversion.to == Units::UnitId::Invalid)
+      {
+         throw std::invalid_argument("unitconv: unknown unit " + std::string(to));
+      }
+      if (Units::GetUnitRecord(conversion.from).dimension != Units::GetUnitRecord(conversion.to).dimension)
+      {
+         throw std::invalid_argument("unitconv: " + std::string(from) + " and " + std::string(to) + " are not of one dimension");
+      }
+      return conversion;
+   }
+
+   Options ParseArguments(int argc, char** argv)
+   {
+      Options options;
+      for (int i = 1; i < argc; ++i)
+      {
+         const std::string_view argument = argv[i];
+         const bool hasValue = (i + 1) < argc;
+         if ((argument == "--col") && hasValue)
+         {
+            options.columns.push_back(ParseColumnSpec(argv[++i]));
+         }
+         else if (argument == "--tsv")
+         {
+            options.delimiter = '\t';
+         }
+         else if ((argument == "--delimiter") && hasValue && (std::strlen(argv[i + 1]) == 1))
+         {
+            options.delimiter = argv[++i][0];
+         }
+         else if (argument == "--no-header")
+         {
+            options.header = false;
+         }
+         else if ((argument == "--precision") && hasValue)
+         {
+            options.precision = int(std::min(ParseCount(argv[++i], "--precision"), unsigned(Units::Formatting::MAX_PRECISION)));
+         }
+         else if ((argument == "--threads") && hasValue)
+         {
+            options.threads = ParseCount(argv[++i], "--threads");
+         }
+         else if ((argument == "-o") && hasValue)
+         {
+            options.output = argv[++i];
+         }
+         else if (!argument.starts_with("-") && options.input.empty())
+         {
+            options.input = argument;
+         }
+         else
+         {
+            throw std::invalid_argument("unitconv: unexpected argument " + std::string(argument));
+         }
+      }
+
+      if (options.input.empty() || options.columns.empty())
+      {
+         throw std::invalid_argument("unitconv: an input file and at least one --col are required");
+      }
+      if (options.threads == 0)
+      {
+         options.threads = std::max(1u, std::thread::hardware_concurrency());
+      }
+      return options;
+   }
+
+   // Read only mapping of a whole file
+   class MappedFile
+   {
+   public:
+      explicit MappedFile(const std::string& path)
+      {
+         const int descriptor = ::open(path.c_str(), O_RDONLY);
+         if (descriptor < 0)
+         {
+            throw std::system_error(errno, std::generic_category(), "unitconv: cannot open " + path);
+         }
+
+         struct stat status;
+         if (::fstat(descriptor, &status) != 0)
+         {
+            const int error = errno;
+            ::close(descriptor);
+            throw std::system_error(error, std::generic_category(), "unitconv: cannot stat " + path);
+         }
+         if (!S_ISREG(status.st_mode))
+         {
+            ::close(descriptor);
+            throw std::invalid_argument("unitconv: " + path + " is not a regular file, pipes cannot be mapped");
+         }
+
+         m_size = std::size_t(status.st_size);
+         if (m_size > 0)
+         {
+            m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+         }
+         const int error = errno;
+         ::close(descriptor);
+         if (m_data == MAP_FAILED)
+         {
+            throw std::system_error(error, std::generic_category(), "unitconv: cannot map " + path);
+         }
+         if (m_size > 0)
+         {
+            ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+         }
+      }
+      ~MappedFile()
+      {
+         if ((m_data != MAP_FAILED) && (m_data != nullptr))
+         {
+            ::munmap(m_data, m_size);
+         }
+      }
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      std::string_view Text() const
+      {
+         return (m_data == nullptr) ? std::string_view() : std::string_view(static_cast<const char*>(m_data), m_size);
+      }
+
+   private:
+      void* m_data = nullptr;
+      std::size_t m_size = 0;
+   };
+
+   void WriteAll(int descriptor, const char* data, std::size_t size)
+   {
+      while (size > 0)
+      {
+         const ssize_t written = ::write(descriptor, data, size);
+         if (written < 0)
+         {
+            if (errno == EINTR)
+            {
+               continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "unitconv: write failed");
+         }
+         data += written;
+         size -= std::size_t(written);
+      }
+   }
+
+   // Everything a worker needs to convert a chunk, byColumn holds the
+   // conversion of each column index or nullptr to copy it
+   struct Layout
+   {
+      std::vector<const ColumnConversion*> byColumn;
+      char delimiter;
+      int precision;
+   };
+
+   // End of the field starting at first, a quoted field runs to its closing quote
+   const char* FieldEnd(const char* first, const char* last, char delimiter)
+   {
+      if ((first != last) && (*first == '"'))
+      {
+         ++first;
+         while (first != last)
+         {
+            if (*first == '"')
+            {
+               if (((first + 1) == last) || (first[1] != '"'))
+               {
+                  ++first;
+                  break;
+               }
+               ++first;
+            }
+            ++first;
+         }
+      }
+      const char* const end = static_cast<const char*>(std::memchr(first, delimiter, std::size_t(last - first)));
+      return (end == nullptr) ? last : end;
+   }
+
+   // Converts the number in [first, last) surrounded by optional blanks,
+   // appending the text before it and the converted number to output.
+   // Returns false to leave the field as it is.
+   bool ConvertField(const char* first, const char* last, const ColumnConversion& conversion, int precision,
+      const char*& copied, std::string& output)
+   {
+      const std::string_view field = Trim(std::string_view(first, std::size_t(last - first)));
+      if (field.empty())
+      {
+         return true;
+      }
+
+      double value = 0.0;
+      const char* number = field.data();
+      const char* const numberEnd = field.data() + field.size();
+      const std::from_chars_result parsed = std::from_chars(number + ((*number == '+') ? 1 : 0), numberEnd, value);
+      if ((parsed.ec != std::errc()) || (parsed.ptr != numberEnd))
+      {
+         return false;
+      }
+
+      char buffer[Units::Formatting::MAX_NUMBER_LENGTH];
+      const std::to_chars_result formatted = Units::FormatValue(buffer, buffer + sizeof(buffer),
+         Units::convert(value, conversion.from, conversion.to), std::string_view(), precision);
+      if (formatted.ec != std::errc())
+      {
+         return false;
+      }
+
+      output.append(copied, number);
+      output.append(buffer, formatted.ptr);
+      copied = numberEnd;
+      return true;
+   }
+
+   void ConvertChunk(std::string_view chunk, const Layout& layout, std::string& output, Statistics& statistics)
+   {
+      // Converted numbers rarely grow the text by more than half
+      output.clear();
+      output.reserve(chunk.size() + (chunk.size() / 2));
+
+      std::size_t rows = 0;
+      std::size_t unconverted = 0;
+      const char* copied = chunk.data();
+      const char* line = chunk.data();
+      const char* const chunkEnd = chunk.data() + chunk.size();
+      while (line != chunkEnd)
+      {
+         const char* const newline = static_cast<const char*>(std::memchr(line, '\n', std::size_t(chunkEnd - line)));
+         const char* lineEnd = (newline == nullptr) ? chunkEnd : newline;
+         const char* const next = (newline == nullptr) ? chunkEnd : (newline + 1);
+         if ((lineEnd != line) && (lineEnd[-1] == '\r'))
+         {
+            --lineEnd;
+         }
+         ++rows;
+
+         const char* field = line;
+         for (std::size_t column = 0; column < layout.byColumn.size(); ++column)
+         {
+            const char* const fieldEnd = FieldEnd(field, lineEnd, layout.delimiter);
+            const ColumnConversion* const conversion = layout.byColumn[column];
+            if ((conversion != nullptr) && !ConvertField(field, fieldEnd, *conversion, layout.precision, copied, output))
+            {
+               ++unconverted;
+            }
+            if (fieldEnd == lineEnd)
+            {
+               break;
+            }
+            field = fieldEnd + 1;
+         }
+         line = next;
+      }
+      output.append(copied, chunkEnd);
+
+      statistics.rows += rows;
+      statistics.unconverted += unconverted;
+   }
+
+   // Cuts text into chunks of about CHUNK_SIZE ending on line boundaries
+   std::vector<std::string_view> SplitChunks(std::string_view text)
+   {
+      std::vector<std::string_view> chunks;
+      while (!text.empty())
+      {
+         std::size_t end = text.size();
+         if (text.size() > CHUNK_SIZE)
+         {
+            const std::size_t newline = text.find('\n', CHUNK_SIZE);
+            end = (newline == std::string_view::npos) ? text.size() : (newline + 1);
+         }
+         chunks.push_back(text.substr(0, end));
+         text.remove_prefix(end);
+      }
+      return chunks;
+   }
+
+   // Finds the column index of every conversion, by header name or by number
+   Layout MakeLayout(Options& options, std::string_view header)
+   {
+      std::vector<std::string_view> names;
+      if (options.header)
+      {
+         const char* field = header.data();
+         const char* const last = header.data() + header.size();
+         while (true)
+         {
+            const char* const fieldEnd = FieldEnd(field, last, options.delimiter);
+            std::string_view name = Trim(std::string_view(field, std::size_t(fieldEnd - field)));
+            if ((name.size() >= 2) && (name.front() == '"') && (name.back() == '"'))
+            {
+               name = name.substr(1, name.size() - 2);
+            }
+            names.push_back(name);
+            if (fieldEnd == last)
+            {
+               break;
+            }
+            field = fieldEnd + 1;
+         }
+      }
+
+      Layout layout{ {}, options.delimiter, options.precision };
+      for (ColumnConversion& conversion : options.columns)
+      {
+         const auto named = std::find(names.begin(), names.end(), conversion.name);
+         if (named != names.end())
+         {
+            conversion.column = std::size_t(named - names.begin());
+         }
+         else
+         {
+            const std::from_chars_result result = std::from_chars(conversion.name.data(), conversion.name.data() + conversion.name.size(), conversion.column);
+            if ((result.ec != std::errc()) || (result.ptr != (conversion.name.data() + conversion.name.size())))
+            {
+               throw std::invalid_argument("unitconv: no column named " + conversion.name);
+            }
+         }
+
+         if (conversion.column >= layout.byColumn.size())
+         {
+            layout.byColumn.resize(conversion.column + 1, nullptr);
+         }
+         if (layout.byColumn[conversion.column] != nullptr)
+         {
+            throw std::invalid_argument("unitconv: column " + conversion.name + " is converted twice");
+         }
+         layout.byColumn[conversion.column] = &conversion;
+      }
+      return layout;
+   }
+
+   // Chunks are claimed in order by the workers and written in order by the
+   // calling thread, at most window chunks ahead of the writer
+   class Pipeline
+   {
+   public:
+      Pipeline(std::vector<std::string_view> chunks, const Layout& layout, unsigned threads) :
+         m_chunks(std::move(chunks)), m_outputs(m_chunks.size()), m_ready(m_chunks.size(), false),
+         m_layout(layout), m_window(std::size_t(threads) * CHUNKS_IN_FLIGHT)
+      {
+         for (unsigned i = 0; i < threads; ++i)
+         {
+            m_workers.emplace_back([this] { Work(); });
+         }
+      }
+      ~Pipeline()
+      {
+         {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+         }
+         m_consumed.notify_all();
+         for (std::thread& worker : m_workers)
+         {
+            worker.join();
+         }
+      }
+
+      void WriteTo(int descriptor)
+      {
+         for (std::size_t i = 0; i < m_chunks.size(); ++i)
+         {
+            {
+               std::unique_lock<std::mutex> lock(m_mutex);
+               m_produced.wait(lock, [&] { return m_ready[i]; });
+            }
+
+            WriteAll(descriptor, m_outputs[i].data(), m_outputs[i].size());
+            std::string().swap(m_outputs[i]);
+
+            {
+               std::lock_guard<std::mutex> lock(m_mutex);
+               m_written = i + 1;
+            }
+            m_consumed.notify_all();
+         }
+      }
+
+      Statistics statistics;
+
+   private:
+      void Work()
+      {
+         while (true)
+         {
+            std::size_t chunk = 0;
+            {
+               std::unique_lock<std::mutex> lock(m_mutex);
+               m_consumed.wait(lock, [&] { return m_stopping || (m_next == m_chunks.size()) || (m_next < (m_written + m_window)); });
+               if (m_stopping || (m_next == m_chunks.size()))
+               {
+                  return;
+               }
+               chunk = m_next++;
+            }
+
+            ConvertChunk(m_chunks[chunk], m_layout, m_outputs[chunk], statistics);
+
+            {
+               std::lock_guard<std::mutex> lock(m_mutex);
+               m_ready[chunk] = true;
+            }
+            m_produced.notify_all();
+         }
+      }
+
+      std::vector<std::string_view> m_chunks;
+      std::vector<std::string> m_outputs;
+      std::vector<bool> m_ready;
+      const Layout& m_layout;
+      const std::size_t m_window;
+
+      std::mutex m_mutex;
+      std::condition_variable m_produced;
+      std::condition_variable m_consumed;
+      std::size_t m_next = 0;
+      std::size_t m_written = 0;
+      bool m_stopping = false;
+      std::vector<std::thread> m_workers;
+   };
+
+   int Run(Options& options)
+   {
+      const auto start = std::chrono::steady_clock::now();
+
+      const MappedFile input(options.input);
+      std::string_view text = input.Text();
+
+      std::string_view header;
+      if (options.header)
+      {
+         const std::size_t newline = text.find('\n');
+         header = text.substr(0, newline);
+         text.remove_prefix((newline == std::string_view::npos) ? text.size() : (newline + 1));
+      }
+      const std::string_view headerLine = input.Text().substr(0, input.Text().size() - text.size());
+      if (!header.empty() && (header.back() == '\r'))
+      {
+         header.remove_suffix(1);
+      }
+      const Layout layout = MakeLayout(options, header);
+
+      int descriptor = STDOUT_FILENO;
+      if (!options.output.empty())
+      {
+         descriptor = ::open(options.output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+         if (descriptor < 0)
+         {
+            throw std::system_error(errno, std::generic_category(), "unitconv: cannot create " + options.output);
+         }
+      }
+
+      std::size_t rows = 0;
+      std::size_t unconverted = 0;
+      try
+      {
+         WriteAll(descriptor, headerLine.data(), headerLine.size());
+         Pipeline pipeline(SplitChunks(text), layout, options.threads);
+         pipeline.WriteTo(descriptor);
+         rows = pipeline.statistics.rows;
+         unconverted = pipeline.statistics.unconverted;
+      }
+      catch (...)
+      {
+         if (descriptor != STDOUT_FILENO)
+         {
+            ::close(descriptor);
+         }
+         throw;
+      }
+      if ((descriptor != STDOUT_FILENO) && (::close(descriptor) != 0))
+      {
+         throw std::system_error(errno, std::generic_category(), "unitconv: cannot close " + options.output);
+      }
+
+      const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      const double megabytes = double(input.Text().size()) / 1.0e6;
+      std::fprintf(stderr, "unitconv: %zu rows, %.1f MB in %.3f s, %.0f rows/s, %.1f MB/s, %zu fields left unconverted\n",
+         rows, megabytes, seconds, double(rows) / seconds, megabytes / seconds, unconverted);
+      return 0;
+   }
+} //end anonymous namespace
+
+int main(int argc, char** argv)
+{
+   Options options;
+   try
+   {
+      options = ParseArguments(argc, argv);
+   }
+   catch (const std::exception& error)
+   {
+      std::fprintf(stderr, "%s\n", error.what());
+      PrintUsage();
+      return 2;
+   }
+
+   try
+   {
+      return Run(options);
+   }
+   catch (const std::exception& error)
+   {
+      std::fprintf(stderr, "%s\n", error.what());
+      return 1;
+   }
+}